@@ -0,0 +1,514 @@
+#ifndef BUSCA_LOCAL_HPP
+#define BUSCA_LOCAL_HPP
+
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "grafo.hpp"             // Servico
+#include "matriz_distancias.hpp" // VisaoMatrizDistancias, DIST_INF_SATURADO
+#include "solucao.hpp"           // Solucao, Rota, Visita
+
+using namespace std;
+
+// Busca local sobre as rotas da solução, com as vizinhanças:
+//   - troca de segmentos entre duas rotas (cross-exchange com até tamanhoMaxSegmento serviços de cada lado,
+//     o que inclui realocação (1,0) e troca (1,1)), podendo inverter o segmento inserido;
+//   - 2-opt* entre duas rotas (troca dos finais das rotas, também na forma invertida);
+//   - dentro de uma rota: realocação de segmentos (or-opt), troca de dois serviços, 2-opt (inversão de um
+//     trecho) e inversão do sentido de atendimento de uma aresta.
+// Cada rota mantém agregados de prefixo (carga, custo no sentido normal e no sentido invertido, nós de
+// entrada/saída), e toda rota nova é descrita como uma concatenação de no máximo cinco trechos das rotas
+// atuais. Assim cada movimento é avaliado em O(1) a partir da matriz de distâncias entre nós-chave.
+
+enum class ModoBuscaLocal
+{
+    NENHUMA,
+    PRIMEIRA, // Aplica o primeiro movimento de melhora encontrado
+    MELHOR    // Avalia toda a vizinhança e aplica o melhor movimento
+};
+
+const int TAMANHO_SEGMENTO_BL = 2; // Maior segmento movido pelas trocas de segmentos e pelo or-opt
+
+struct ConfigBuscaLocal
+{
+    ModoBuscaLocal modo = ModoBuscaLocal::PRIMEIRA;
+    int tamanhoMaxSegmento = TAMANHO_SEGMENTO_BL;
+};
+
+struct EstatisticasBuscaLocal
+{
+    long long movimentosAvaliados = 0;
+    long long movimentosAplicados = 0;
+    double segundos = 0;
+
+    double movimentosPorSegundo() const { return segundos > 0 ? movimentosAvaliados / segundos : 0; }
+};
+
+// Custo usado para deslocamentos impossíveis: grande o bastante para nenhum movimento que o crie ser
+// aceito, e pequeno o bastante para somas de alguns deles não estourarem.
+const long long CUSTO_INALCANCAVEL_BL = 1000000000000000LL;
+
+class BuscaLocal
+{
+public:
+    BuscaLocal(const vector<Servico> &servicos_, VisaoMatrizDistancias dist_, int chaveDeposito_, int capacidade_,
+               const ConfigBuscaLocal &config_)
+        : servicos(servicos_), dist(dist_), chaveDeposito(chaveDeposito_), capacidade(capacidade_), config(config_) {}
+
+    // Melhora a solução até um ótimo local. Rotas que ficarem vazias são removidas e os custos são recalculados.
+    // Se rotasAlteradas for informado, a solução é tratada como um ótimo local exceto nessas rotas: apenas
+    // pares de rotas com alguma rota alterada são explorados de início (usado após uma perturbação).
+    EstatisticasBuscaLocal otimizar(Solucao &solucao, const vector<char> *rotasAlteradas = nullptr)
+    {
+        auto inicio = chrono::steady_clock::now();
+        estat = EstatisticasBuscaLocal();
+        rotas = &solucao.rotas;
+        const int numRotas = static_cast<int>(rotas->size());
+        agregados.assign(numRotas, Agregados());
+        for (int r = 0; r < numRotas; ++r)
+            atualizarAgregados(r);
+
+        // Um par (a, b) só precisa ser explorado de novo se uma das rotas mudou depois da última exploração
+        relogio = 1;
+        alteradaEm.assign(numRotas, 1);
+        if (rotasAlteradas)
+            for (int r = 0; r < numRotas; ++r)
+                alteradaEm[r] = (*rotasAlteradas)[r] ? 1 : 0;
+        exploradoEm.assign(static_cast<size_t>(numRotas) * numRotas, 0);
+        auto precisaExplorar = [&](int a, int b)
+        { return max(alteradaEm[a], alteradaEm[b]) > exploradoEm[static_cast<size_t>(a) * numRotas + b]; };
+
+        if (config.modo == ModoBuscaLocal::PRIMEIRA)
+        {
+            bool melhorou = true;
+            while (melhorou)
+            {
+                melhorou = false;
+                for (int a = 0; a < numRotas; ++a)
+                {
+                    for (int b = a; b < numRotas; ++b)
+                    {
+                        if (!precisaExplorar(a, b))
+                            continue;
+                        melhor.delta = 0;
+                        while (explorar(a, b))
+                        {
+                            aplicar(melhor);
+                            melhor.delta = 0;
+                            melhorou = true;
+                        }
+                        exploradoEm[static_cast<size_t>(a) * numRotas + b] = relogio;
+                    }
+                }
+            }
+        }
+        else if (config.modo == ModoBuscaLocal::MELHOR)
+        {
+            // Guarda o melhor movimento de cada par; após aplicar um movimento, só os pares das rotas
+            // alteradas são reavaliados.
+            melhorDoPar.assign(static_cast<size_t>(numRotas) * numRotas, Movimento());
+            while (true)
+            {
+                Movimento escolhido;
+                for (int a = 0; a < numRotas; ++a)
+                {
+                    for (int b = a; b < numRotas; ++b)
+                    {
+                        const size_t par = static_cast<size_t>(a) * numRotas + b;
+                        if (precisaExplorar(a, b))
+                        {
+                            melhor.delta = 0;
+                            explorar(a, b);
+                            melhorDoPar[par] = melhor;
+                            exploradoEm[par] = relogio;
+                        }
+                        if (melhorDoPar[par].delta < escolhido.delta)
+                            escolhido = melhorDoPar[par];
+                    }
+                }
+                if (escolhido.delta >= 0)
+                    break;
+                aplicar(escolhido);
+            }
+        }
+
+        solucao.rotas.erase(remove_if(solucao.rotas.begin(), solucao.rotas.end(), [](const Rota &r)
+                                      { return r.visitas.empty(); }),
+                            solucao.rotas.end());
+        solucao.custoTotal = 0;
+        for (Rota &r : solucao.rotas)
+        {
+            recalcularRota(r, servicos, dist, chaveDeposito);
+            solucao.custoTotal += r.custo;
+        }
+        estat.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        return estat;
+    }
+
+private:
+    // Agregados de prefixo de uma rota com n visitas (posições 0..n-1).
+    struct Agregados
+    {
+        int n = 0;
+        vector<int> entrada, saida;          // Nós-chave de entrada/saída de cada visita
+        vector<int> entradaInv, saidaInv;    // Idem, com o sentido da visita invertido (só muda arestas)
+        vector<long long> conexao;           // conexao[k]: deslocamento da saída da visita k-1 (ou depósito) até a entrada de k
+        vector<long long> custoAte;          // custoAte[k]: custo do depósito até o fim da visita k-1 (n+1 posições)
+        vector<long long> cargaAte;          // cargaAte[k]: demanda das visitas 0..k-1
+        vector<long long> atendimentoAte;    // atendimentoAte[k]: custos de atendimento das visitas 0..k-1
+        vector<long long> custoInvAte;       // custoInvAte[k]: deslocamentos internos de 0..k percorrido ao contrário
+        long long custoTotal = 0;
+    };
+
+    // Trecho a..b (inclusive) de uma rota, possivelmente percorrido ao contrário; a > b indica trecho vazio.
+    struct Peca
+    {
+        int rota;
+        int a, b;
+        bool invertida;
+    };
+
+    // Nova configuração de até duas rotas, descrita por peças das rotas atuais.
+    struct Movimento
+    {
+        long long delta = 0;
+        int rotaA = -1, rotaB = -1; // rotaB = -1 para movimentos dentro de uma rota
+        int numPecasA = 0, numPecasB = 0;
+        Peca pecasA[5], pecasB[5];
+    };
+
+    long long d(int origem, int destino) const
+    {
+        long long v = dist.linha(origem)[destino];
+        return v >= DIST_INF_SATURADO ? CUSTO_INALCANCAVEL_BL : v;
+    }
+
+    void atualizarAgregados(int r)
+    {
+        const vector<Visita> &vis = (*rotas)[r].visitas;
+        Agregados &ag = agregados[r];
+        const int n = static_cast<int>(vis.size());
+        ag.n = n;
+        ag.entrada.resize(n);
+        ag.saida.resize(n);
+        ag.entradaInv.resize(n);
+        ag.saidaInv.resize(n);
+        ag.conexao.resize(n);
+        ag.custoAte.assign(n + 1, 0);
+        ag.cargaAte.assign(n + 1, 0);
+        ag.atendimentoAte.assign(n + 1, 0);
+        ag.custoInvAte.assign(max(n, 1), 0);
+        for (int k = 0; k < n; ++k)
+        {
+            const Servico &s = servicos[vis[k].servico];
+            ag.entrada[k] = chaveEntrada(s, vis[k].invertido);
+            ag.saida[k] = chaveSaida(s, vis[k].invertido);
+            ag.entradaInv[k] = chaveEntrada(s, !vis[k].invertido);
+            ag.saidaInv[k] = chaveSaida(s, !vis[k].invertido);
+            ag.conexao[k] = d(k == 0 ? chaveDeposito : ag.saida[k - 1], ag.entrada[k]);
+            ag.custoAte[k + 1] = ag.custoAte[k] + ag.conexao[k] + custoAtendimento(s);
+            ag.cargaAte[k + 1] = ag.cargaAte[k] + s.demanda;
+            ag.atendimentoAte[k + 1] = ag.atendimentoAte[k] + custoAtendimento(s);
+        }
+        for (int k = 0; k + 1 < n; ++k)
+            ag.custoInvAte[k + 1] = ag.custoInvAte[k] + d(ag.saidaInv[k + 1], ag.entradaInv[k]);
+        ag.custoTotal = n > 0 ? ag.custoAte[n] + d(ag.saida[n - 1], chaveDeposito) : 0;
+    }
+
+    long long carga(const Peca &p) const
+    {
+        return p.a > p.b ? 0 : agregados[p.rota].cargaAte[p.b + 1] - agregados[p.rota].cargaAte[p.a];
+    }
+
+    // Custo de uma rota formada pela concatenação das peças (saindo e voltando ao depósito).
+    long long custoPecas(const Peca *pecas, int numPecas) const
+    {
+        long long custo = 0;
+        int ultima = chaveDeposito;
+        bool vazia = true;
+        for (int i = 0; i < numPecas; ++i)
+        {
+            const Peca &p = pecas[i];
+            if (p.a > p.b)
+                continue;
+            vazia = false;
+            const Agregados &ag = agregados[p.rota];
+            if (!p.invertida)
+            {
+                custo += d(ultima, ag.entrada[p.a]) + ag.custoAte[p.b + 1] - ag.custoAte[p.a] - ag.conexao[p.a];
+                ultima = ag.saida[p.b];
+            }
+            else
+            {
+                custo += d(ultima, ag.entradaInv[p.b]) + ag.atendimentoAte[p.b + 1] - ag.atendimentoAte[p.a] +
+                         ag.custoInvAte[p.b] - ag.custoInvAte[p.a];
+                ultima = ag.saidaInv[p.a];
+            }
+        }
+        return vazia ? 0 : custo + d(ultima, chaveDeposito);
+    }
+
+    // Registra um movimento avaliado. Retorna true se ele deve ser aplicado imediatamente (primeira melhora).
+    bool registrar(const Movimento &m)
+    {
+        estat.movimentosAvaliados++;
+        if (m.delta < melhor.delta)
+        {
+            melhor = m;
+            return config.modo == ModoBuscaLocal::PRIMEIRA;
+        }
+        return false;
+    }
+
+    // Avalia a nova forma de uma rota (movimento interno).
+    bool avaliarIntra(int a, const Peca *pecas, int numPecas)
+    {
+        Movimento m;
+        m.rotaA = a;
+        m.numPecasA = numPecas;
+        copy(pecas, pecas + numPecas, m.pecasA);
+        m.delta = custoPecas(pecas, numPecas) - agregados[a].custoTotal;
+        return registrar(m);
+    }
+
+    // Avalia a nova forma de duas rotas; cargas já verificadas. As peças inseridas na posição indicada
+    // (posInvA/posInvB, -1 se nenhuma) são testadas nos dois sentidos e o melhor é mantido.
+    bool avaliarInter(int a, int b, Peca *pecasA, int numPecasA, int posInvA, Peca *pecasB, int numPecasB, int posInvB)
+    {
+        Movimento m;
+        m.rotaA = a;
+        m.rotaB = b;
+        m.numPecasA = numPecasA;
+        m.numPecasB = numPecasB;
+        long long custoA = melhorSentido(pecasA, numPecasA, posInvA);
+        long long custoB = melhorSentido(pecasB, numPecasB, posInvB);
+        copy(pecasA, pecasA + numPecasA, m.pecasA);
+        copy(pecasB, pecasB + numPecasB, m.pecasB);
+        m.delta = custoA + custoB - agregados[a].custoTotal - agregados[b].custoTotal;
+        return registrar(m);
+    }
+
+    long long melhorSentido(Peca *pecas, int numPecas, int posInv) const
+    {
+        long long custo = custoPecas(pecas, numPecas);
+        if (posInv >= 0 && pecas[posInv].a <= pecas[posInv].b)
+        {
+            pecas[posInv].invertida = !pecas[posInv].invertida;
+            long long custoInv = custoPecas(pecas, numPecas);
+            if (custoInv < custo)
+                custo = custoInv;
+            else
+                pecas[posInv].invertida = !pecas[posInv].invertida;
+        }
+        return custo;
+    }
+
+    // Enumera os movimentos entre as rotas a e b (ou dentro de a, se a == b).
+    // Retorna true se um movimento de primeira melhora foi encontrado (em melhor).
+    bool explorar(int a, int b)
+    {
+        return a == b ? explorarIntra(a) : explorarInter(a, b);
+    }
+
+    bool explorarInter(int a, int b)
+    {
+        const Agregados &A = agregados[a], &B = agregados[b];
+        const int nA = A.n, nB = B.n, K = config.tamanhoMaxSegmento;
+        if (nA == 0 && nB == 0)
+            return false;
+        const long long cargaA = A.cargaAte[nA], cargaB = B.cargaAte[nB];
+
+        // Troca de segmentos A[i..i+la-1] <-> B[j..j+lb-1] (inclui realocação e troca simples)
+        for (int i = 0; i <= nA; ++i)
+        {
+            for (int la = 0; la <= K && i + la <= nA; ++la)
+            {
+                const long long cargaSegA = A.cargaAte[i + la] - A.cargaAte[i];
+                for (int j = 0; j <= nB; ++j)
+                {
+                    for (int lb = (la == 0 ? 1 : 0); lb <= K && j + lb <= nB; ++lb)
+                    {
+                        const long long cargaSegB = B.cargaAte[j + lb] - B.cargaAte[j];
+                        if (cargaA - cargaSegA + cargaSegB > capacidade || cargaB - cargaSegB + cargaSegA > capacidade)
+                            continue;
+                        Peca pa[3] = {{a, 0, i - 1, false}, {b, j, j + lb - 1, false}, {a, i + la, nA - 1, false}};
+                        Peca pb[3] = {{b, 0, j - 1, false}, {a, i, i + la - 1, false}, {b, j + lb, nB - 1, false}};
+                        if (avaliarInter(a, b, pa, 3, 1, pb, 3, 1))
+                            return true;
+                    }
+                }
+            }
+        }
+
+        // 2-opt*: A[0..i] + B[j+1..] e B[0..j] + A[i+1..], ou A[0..i] + inv(B[0..j]) e inv(A[i+1..]) + B[j+1..]
+        for (int i = -1; i < nA; ++i)
+        {
+            const long long iniA = A.cargaAte[i + 1], fimA = cargaA - iniA;
+            for (int j = -1; j < nB; ++j)
+            {
+                const long long iniB = B.cargaAte[j + 1], fimB = cargaB - iniB;
+                if (iniA + fimB <= capacidade && iniB + fimA <= capacidade)
+                {
+                    Peca pa[2] = {{a, 0, i, false}, {b, j + 1, nB - 1, false}};
+                    Peca pb[2] = {{b, 0, j, false}, {a, i + 1, nA - 1, false}};
+                    if (avaliarInter(a, b, pa, 2, -1, pb, 2, -1))
+                        return true;
+                }
+                if (iniA + iniB <= capacidade && fimA + fimB <= capacidade)
+                {
+                    Peca pa[2] = {{a, 0, i, false}, {b, 0, j, true}};
+                    Peca pb[2] = {{a, i + 1, nA - 1, true}, {b, j + 1, nB - 1, false}};
+                    if (avaliarInter(a, b, pa, 2, -1, pb, 2, -1))
+                        return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool explorarIntra(int a)
+    {
+        const Agregados &A = agregados[a];
+        const int n = A.n, K = config.tamanhoMaxSegmento;
+        const vector<Visita> &vis = (*rotas)[a].visitas;
+        auto podeInverter = [&](int k)
+        { return servicos[vis[k].servico].tipo == Servico::Tipo::ARESTA; };
+
+        // Inversão do sentido de uma aresta e 2-opt (inversão do trecho i..j)
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = i; j < n; ++j)
+            {
+                if (i == j && !podeInverter(i))
+                    continue;
+                Peca p[3] = {{a, 0, i - 1, false}, {a, i, j, true}, {a, j + 1, n - 1, false}};
+                if (avaliarIntra(a, p, 3))
+                    return true;
+            }
+        }
+
+        // Or-opt: move o segmento i..i+l-1 para antes da posição pos, em qualquer sentido
+        for (int l = 1; l <= K; ++l)
+        {
+            for (int i = 0; i + l <= n; ++i)
+            {
+                for (int pos = 0; pos <= n; ++pos)
+                {
+                    if (pos >= i && pos <= i + l)
+                        continue;
+                    for (int inv = 0; inv < 2; ++inv)
+                    {
+                        if (inv && l == 1 && !podeInverter(i))
+                            continue;
+                        Peca seg = {a, i, i + l - 1, inv == 1};
+                        Peca p[4];
+                        if (pos < i)
+                        {
+                            p[0] = {a, 0, pos - 1, false};
+                            p[1] = seg;
+                            p[2] = {a, pos, i - 1, false};
+                            p[3] = {a, i + l, n - 1, false};
+                        }
+                        else
+                        {
+                            p[0] = {a, 0, i - 1, false};
+                            p[1] = {a, i + l, pos - 1, false};
+                            p[2] = seg;
+                            p[3] = {a, pos, n - 1, false};
+                        }
+                        if (avaliarIntra(a, p, 4))
+                            return true;
+                    }
+                }
+            }
+        }
+
+        // Troca de dois serviços da rota (cada um em qualquer sentido)
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = i + 1; j < n; ++j)
+            {
+                for (int invI = 0; invI < 2; ++invI)
+                {
+                    if (invI && !podeInverter(i))
+                        continue;
+                    for (int invJ = 0; invJ < 2; ++invJ)
+                    {
+                        if (invJ && !podeInverter(j))
+                            continue;
+                        Peca p[5] = {{a, 0, i - 1, false}, {a, j, j, invJ == 1}, {a, i + 1, j - 1, false},
+                                     {a, i, i, invI == 1}, {a, j + 1, n - 1, false}};
+                        if (avaliarIntra(a, p, 5))
+                            return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // Materializa as peças em uma sequência de visitas.
+    void montarVisitas(const Peca *pecas, int numPecas, vector<Visita> &destino) const
+    {
+        destino.clear();
+        for (int i = 0; i < numPecas; ++i)
+        {
+            const Peca &p = pecas[i];
+            const vector<Visita> &origem = (*rotas)[p.rota].visitas;
+            if (!p.invertida)
+            {
+                for (int k = p.a; k <= p.b; ++k)
+                    destino.push_back(origem[k]);
+            }
+            else
+            {
+                for (int k = p.b; k >= p.a; --k)
+                {
+                    Visita v = origem[k];
+                    if (servicos[v.servico].tipo == Servico::Tipo::ARESTA)
+                        v.invertido = !v.invertido;
+                    destino.push_back(v);
+                }
+            }
+        }
+    }
+
+    void aplicar(const Movimento &m)
+    {
+        montarVisitas(m.pecasA, m.numPecasA, novaA);
+        if (m.rotaB >= 0)
+        {
+            montarVisitas(m.pecasB, m.numPecasB, novaB);
+            (*rotas)[m.rotaB].visitas.swap(novaB);
+        }
+        (*rotas)[m.rotaA].visitas.swap(novaA);
+        ++relogio;
+        atualizarAgregados(m.rotaA);
+        alteradaEm[m.rotaA] = relogio;
+        if (m.rotaB >= 0)
+        {
+            atualizarAgregados(m.rotaB);
+            alteradaEm[m.rotaB] = relogio;
+        }
+        estat.movimentosAplicados++;
+    }
+
+    const vector<Servico> &servicos;
+    VisaoMatrizDistancias dist;
+    int chaveDeposito;
+    long long capacidade;
+    ConfigBuscaLocal config;
+
+    vector<Rota> *rotas = nullptr;
+    vector<Agregados> agregados;
+    Movimento melhor;
+    vector<Movimento> melhorDoPar;  // Modo MELHOR: melhor movimento de cada par de rotas (a <= b)
+    long long relogio = 0;          // Conta os movimentos aplicados (marca de tempo das alterações)
+    vector<long long> alteradaEm;   // Última alteração de cada rota
+    vector<long long> exploradoEm;  // Última exploração completa de cada par de rotas
+    EstatisticasBuscaLocal estat;
+    vector<Visita> novaA, novaB; // Áreas de trabalho de aplicar()
+};
+
+#endif // BUSCA_LOCAL_HPP
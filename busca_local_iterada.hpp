@@ -0,0 +1,193 @@
+#ifndef BUSCA_LOCAL_ITERADA_HPP
+#define BUSCA_LOCAL_ITERADA_HPP
+
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include "grafo.hpp"             // Servico
+#include "matriz_distancias.hpp" // VisaoMatrizDistancias, DIST_INF_SATURADO
+#include "solucao.hpp"           // Solucao, Rota, Visita
+#include "busca_local.hpp"       // BuscaLocal, ConfigBuscaLocal
+
+using namespace std;
+
+// Busca local iterada (ILS) com orçamento de tempo/iterações: a partir do ótimo local da busca local,
+// cada iteração perturba a solução corrente (remove alguns serviços ao acaso e os reinsere na posição mais
+// barata que respeite a capacidade), reotimiza apenas as rotas alteradas e aceita o resultado se ficar a no
+// máximo ACEITACAO_ILS acima da melhor solução; caso contrário volta à melhor. A melhor solução (incumbente)
+// é sempre mantida, junto com o instante em que foi encontrada.
+
+const double ACEITACAO_ILS = 0.01;       // Piora relativa à melhor solução aceita para a solução corrente
+const int MAX_SERVICOS_PERTURBACAO = 30; // Maior número de serviços removidos por perturbação
+
+struct ConfigMetaheuristica
+{
+    double tempoLimite = 0;          // Segundos de busca (0 = sem limite de tempo)
+    long long maxIteracoes = 0;      // Iterações da ILS (0 = sem limite)
+    long long maxSemMelhora = 0;     // Para após este número de iterações sem melhorar a melhor (0 = sem limite)
+    unsigned long long semente = 1;  // Semente do gerador pseudoaleatório
+
+    // A ILS só é executada se algum critério de parada for definido.
+    bool ativa() const { return tempoLimite > 0 || maxIteracoes > 0 || maxSemMelhora > 0; }
+};
+
+struct ResultadoMetaheuristica
+{
+    long long iteracoes = 0;
+    long long melhorias = 0;   // Vezes em que a melhor solução foi atualizada
+    long long custoInicial = 0;
+    chrono::high_resolution_clock::time_point momentoMelhor; // Quando a melhor solução final foi encontrada
+};
+
+class BuscaLocalIterada
+{
+public:
+    BuscaLocalIterada(const vector<Servico> &servicos_, VisaoMatrizDistancias dist_, int chaveDeposito_,
+                      int capacidade_, const ConfigBuscaLocal &configBL, const ConfigMetaheuristica &config_)
+        : servicos(servicos_), dist(dist_), chaveDeposito(chaveDeposito_), capacidade(capacidade_), config(config_),
+          buscaLocal(servicos_, dist_, chaveDeposito_, capacidade_, configBL), gerador(config_.semente) {}
+
+    // Executa a ILS a partir de solucao (já um ótimo local de configBL, que não pode ser NENHUMA) e devolve
+    // nela a melhor solução encontrada.
+    ResultadoMetaheuristica executar(Solucao &solucao)
+    {
+        ResultadoMetaheuristica resultado;
+        resultado.custoInicial = solucao.custoTotal;
+        resultado.momentoMelhor = chrono::high_resolution_clock::now();
+        const auto limite = resultado.momentoMelhor + chrono::duration_cast<chrono::high_resolution_clock::duration>(
+                                                          chrono::duration<double>(config.tempoLimite));
+
+        int totalVisitas = 0;
+        for (const Rota &r : solucao.rotas)
+            totalVisitas += static_cast<int>(r.visitas.size());
+        if (totalVisitas < 2)
+            return resultado;
+
+        Solucao corrente = solucao;
+        long long semMelhora = 0;
+        while ((config.maxIteracoes == 0 || resultado.iteracoes < config.maxIteracoes) &&
+               (config.maxSemMelhora == 0 || semMelhora < config.maxSemMelhora) &&
+               (config.tempoLimite <= 0 || chrono::high_resolution_clock::now() < limite))
+        {
+            resultado.iteracoes++;
+            semMelhora++;
+            perturbar(corrente, totalVisitas);
+            buscaLocal.otimizar(corrente, &rotasAlteradas);
+
+            if (corrente.custoTotal < solucao.custoTotal)
+            {
+                solucao = corrente;
+                resultado.melhorias++;
+                resultado.momentoMelhor = chrono::high_resolution_clock::now();
+                semMelhora = 0;
+            }
+            else if (corrente.custoTotal > solucao.custoTotal * (1 + ACEITACAO_ILS))
+            {
+                corrente = solucao;
+            }
+        }
+        return resultado;
+    }
+
+private:
+    long long d(int origem, int destino) const
+    {
+        long long v = dist.linha(origem)[destino];
+        return v >= DIST_INF_SATURADO ? CUSTO_INALCANCAVEL_BL : v;
+    }
+
+    // Ruína e reconstrução: remove de 2 a MAX_SERVICOS_PERTURBACAO serviços ao acaso e reinsere cada um, em
+    // ordem aleatória, na posição e no sentido mais baratos entre as rotas com capacidade (ou em uma rota nova).
+    // Marca em rotasAlteradas as rotas modificadas.
+    void perturbar(Solucao &s, int totalVisitas)
+    {
+        const int maxRemover = max(2, min(MAX_SERVICOS_PERTURBACAO, totalVisitas / 5));
+        const int numRemover = uniform_int_distribution<int>(2, maxRemover)(gerador);
+
+        // Sorteia as posições removidas entre todas as visitas da solução
+        posicoes.clear();
+        for (int r = 0; r < static_cast<int>(s.rotas.size()); ++r)
+            for (int k = 0; k < static_cast<int>(s.rotas[r].visitas.size()); ++k)
+                posicoes.push_back({r, k});
+        for (int i = 0; i < numRemover; ++i)
+            swap(posicoes[i], posicoes[uniform_int_distribution<int>(i, static_cast<int>(posicoes.size()) - 1)(gerador)]);
+        sort(posicoes.begin(), posicoes.begin() + numRemover, [](const pair<int, int> &x, const pair<int, int> &y)
+             { return x > y; }); // Remove do fim para o início para não deslocar as posições restantes
+
+        rotasAlteradas.assign(s.rotas.size(), 0);
+        removidos.clear();
+        for (int i = 0; i < numRemover; ++i)
+        {
+            Rota &rota = s.rotas[posicoes[i].first];
+            removidos.push_back(rota.visitas[posicoes[i].second].servico);
+            rota.visitas.erase(rota.visitas.begin() + posicoes[i].second);
+            rota.demanda -= servicos[removidos.back()].demanda;
+            rotasAlteradas[posicoes[i].first] = 1;
+        }
+        shuffle(removidos.begin(), removidos.end(), gerador);
+
+        for (int idServico : removidos)
+        {
+            const Servico &serv = servicos[idServico];
+            long long melhorCusto = -1;
+            int melhorRota = -1, melhorPos = 0;
+            bool melhorInvertido = false;
+            for (int r = 0; r < static_cast<int>(s.rotas.size()); ++r)
+            {
+                const Rota &rota = s.rotas[r];
+                if (rota.visitas.empty() || rota.demanda + serv.demanda > capacidade)
+                    continue;
+                const int n = static_cast<int>(rota.visitas.size());
+                for (int pos = 0; pos <= n; ++pos)
+                {
+                    int anterior = pos == 0 ? chaveDeposito
+                                            : chaveSaida(servicos[rota.visitas[pos - 1].servico], rota.visitas[pos - 1].invertido);
+                    int seguinte = pos == n ? chaveDeposito
+                                            : chaveEntrada(servicos[rota.visitas[pos].servico], rota.visitas[pos].invertido);
+                    for (int inv = 0; inv < (serv.tipo == Servico::Tipo::ARESTA ? 2 : 1); ++inv)
+                    {
+                        long long custo = d(anterior, chaveEntrada(serv, inv == 1)) +
+                                          d(chaveSaida(serv, inv == 1), seguinte) - d(anterior, seguinte);
+                        if (melhorRota == -1 || custo < melhorCusto)
+                        {
+                            melhorCusto = custo;
+                            melhorRota = r;
+                            melhorPos = pos;
+                            melhorInvertido = inv == 1;
+                        }
+                    }
+                }
+            }
+            if (melhorRota == -1)
+            {
+                // Nenhuma rota comporta o serviço: abre uma rota nova
+                s.rotas.push_back(Rota());
+                rotasAlteradas.push_back(1);
+                melhorRota = static_cast<int>(s.rotas.size()) - 1;
+                melhorInvertido = serv.tipo == Servico::Tipo::ARESTA &&
+                                  d(chaveDeposito, serv.chaveV) + d(serv.chaveU, chaveDeposito) <
+                                      d(chaveDeposito, serv.chaveU) + d(serv.chaveV, chaveDeposito);
+            }
+            Rota &destino = s.rotas[melhorRota];
+            destino.visitas.insert(destino.visitas.begin() + melhorPos, Visita{idServico, melhorInvertido});
+            destino.demanda += serv.demanda;
+            rotasAlteradas[melhorRota] = 1;
+        }
+    }
+
+    const vector<Servico> &servicos;
+    VisaoMatrizDistancias dist;
+    int chaveDeposito;
+    long long capacidade;
+    ConfigMetaheuristica config;
+
+    BuscaLocal buscaLocal;
+    mt19937_64 gerador;
+    vector<pair<int, int>> posicoes; // (rota, posição) de todas as visitas, para o sorteio
+    vector<int> removidos;
+    vector<char> rotasAlteradas;
+};
+
+#endif // BUSCA_LOCAL_ITERADA_HPP
@@ -0,0 +1,226 @@
+#ifndef CACHE_INSTANCIAS_HPP
+#define CACHE_INSTANCIAS_HPP
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <type_traits>
+
+#include "grafo.hpp"             // Grafo, Vertice, Aresta, Arco, Servico, DadosInstancia
+#include "matriz_distancias.hpp" // VisaoMatrizDistancias
+#include "nos_chave.hpp"         // NosChave
+#include "leitura_rapida.hpp"    // ArquivoMapeado
+
+using namespace std;
+
+// Cache binário de instâncias pré-processadas. Cada arquivo guarda o grafo lido (vértices, arestas e
+// arcos), a lista de serviços (com os IDs de nós-chave) e a matriz de distâncias entre nós-chave, e é
+// identificado por um hash do conteúdo do .dat. O arquivo é mapeado em memória somente para leitura e
+// os vetores são usados diretamente, sem desserialização: cada seção começa alinhada a 64 bytes e
+// guarda as estruturas com o mesmo layout da memória (o cabeçalho registra os tamanhos para detectar
+// caches gerados por outra versão do programa).
+
+const char MAGICA_CACHE[8] = {'M', 'C', 'G', 'R', 'P', 'C', 'H', '\0'};
+const uint32_t VERSAO_CACHE = 1;
+
+static_assert(is_trivially_copyable<Vertice>::value && is_trivially_copyable<Aresta>::value &&
+                  is_trivially_copyable<Arco>::value && is_trivially_copyable<Servico>::value,
+              "As estruturas gravadas no cache devem poder ser copiadas byte a byte");
+
+struct CabecalhoCache
+{
+    char magica[8];
+    uint32_t versao;
+    uint32_t tamCabecalho;
+    uint64_t hashConteudo; // Hash do texto do .dat que gerou este cache
+    uint32_t tamVertice, tamAresta, tamArco, tamServico;
+    int32_t numNos, idNoDeposito, capacidadeVeiculo, chaveDeposito, numChaves, reservado;
+    uint64_t numVertices, numArestas, numArcos, numServicos;
+    uint64_t passoMatriz; // Elementos por linha da matriz de nós-chave
+    uint64_t offVertices, offArestas, offArcos, offServicos, offNoDaChave, offMatriz;
+    uint64_t tamTotal;
+};
+
+// Hash FNV-1a de 64 bits do conteúdo de uma instância.
+uint64_t hashConteudoInstancia(string_view texto)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : texto)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Caminho do arquivo de cache de uma instância: "<pasta>/<nome>-<hash em hexadecimal>.mcgc".
+string caminhoCacheInstancia(const string &pastaCache, const string &nomeInstancia, uint64_t hash)
+{
+    char hashHex[17];
+    snprintf(hashHex, sizeof(hashHex), "%016llx", static_cast<unsigned long long>(hash));
+    return (std::filesystem::path(pastaCache) / (nomeInstancia + "-" + hashHex + ".mcgc")).string();
+}
+
+// Grava o cache de uma instância. O arquivo é escrito com outro nome e renomeado ao final,
+// para que uma execução concorrente nunca encontre um cache pela metade.
+bool gravarCacheInstancia(const string &caminho, uint64_t hash, const DadosInstancia &dados,
+                          const vector<Servico> &servicos, const NosChave &nosChave)
+{
+    auto alinhar64 = [](uint64_t x)
+    { return (x + 63) & ~uint64_t(63); };
+
+    CabecalhoCache cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_CACHE, sizeof(cab.magica));
+    cab.versao = VERSAO_CACHE;
+    cab.tamCabecalho = sizeof(CabecalhoCache);
+    cab.hashConteudo = hash;
+    cab.tamVertice = sizeof(Vertice);
+    cab.tamAresta = sizeof(Aresta);
+    cab.tamArco = sizeof(Arco);
+    cab.tamServico = sizeof(Servico);
+    cab.numNos = dados.g.V;
+    cab.idNoDeposito = dados.idNoDeposito;
+    cab.capacidadeVeiculo = dados.capacidadeVeiculo;
+    cab.chaveDeposito = nosChave.chaveDeposito;
+    cab.numChaves = nosChave.numChaves();
+    cab.numVertices = dados.g.vertices.size();
+    cab.numArestas = dados.g.arestas.size();
+    cab.numArcos = dados.g.arcos.size();
+    cab.numServicos = servicos.size();
+    cab.passoMatriz = nosChave.dist.passo();
+
+    const uint64_t tamMatriz = (static_cast<uint64_t>(cab.numChaves) + 1) * cab.passoMatriz * sizeof(long long);
+    cab.offVertices = alinhar64(sizeof(CabecalhoCache));
+    cab.offArestas = alinhar64(cab.offVertices + cab.numVertices * sizeof(Vertice));
+    cab.offArcos = alinhar64(cab.offArestas + cab.numArestas * sizeof(Aresta));
+    cab.offServicos = alinhar64(cab.offArcos + cab.numArcos * sizeof(Arco));
+    cab.offNoDaChave = alinhar64(cab.offServicos + cab.numServicos * sizeof(Servico));
+    cab.offMatriz = alinhar64(cab.offNoDaChave + nosChave.noDaChave.size() * sizeof(int));
+    cab.tamTotal = cab.offMatriz + tamMatriz;
+
+    string caminhoTemp = caminho + ".tmp";
+    {
+        ofstream arq(caminhoTemp, ios::binary | ios::trunc);
+        if (!arq.is_open())
+            return false;
+        uint64_t posicao = 0;
+        auto escrever = [&](uint64_t offset, const void *p, uint64_t tam)
+        {
+            static const char zeros[64] = {0};
+            arq.write(zeros, static_cast<streamsize>(offset - posicao)); // Preenchimento de alinhamento
+            arq.write(static_cast<const char *>(p), static_cast<streamsize>(tam));
+            posicao = offset + tam;
+        };
+        escrever(0, &cab, sizeof(cab));
+        escrever(cab.offVertices, dados.g.vertices.data(), cab.numVertices * sizeof(Vertice));
+        escrever(cab.offArestas, dados.g.arestas.data(), cab.numArestas * sizeof(Aresta));
+        escrever(cab.offArcos, dados.g.arcos.data(), cab.numArcos * sizeof(Arco));
+        escrever(cab.offServicos, servicos.data(), cab.numServicos * sizeof(Servico));
+        escrever(cab.offNoDaChave, nosChave.noDaChave.data(), nosChave.noDaChave.size() * sizeof(int));
+        escrever(cab.offMatriz, nosChave.dist.dadosBrutos(), tamMatriz);
+        if (!arq.good())
+            return false;
+    }
+    error_code ec;
+    std::filesystem::rename(caminhoTemp, caminho, ec);
+    return !ec;
+}
+
+// Cache de uma instância mapeado em memória. Os ponteiros apontam diretamente para o arquivo mapeado.
+class CacheInstanciaMapeado
+{
+public:
+    // Abre e valida o cache. Retorna false se o arquivo não existir, estiver corrompido
+    // ou não corresponder ao hash/versão esperados.
+    bool abrir(const string &caminho, uint64_t hashEsperado)
+    {
+        auto mapa = make_unique<ArquivoMapeado>(caminho);
+        if (!mapa->estaAberto() || mapa->tamanho() < sizeof(CabecalhoCache))
+            return false;
+        const CabecalhoCache *c = reinterpret_cast<const CabecalhoCache *>(mapa->dados());
+        if (memcmp(c->magica, MAGICA_CACHE, sizeof(c->magica)) != 0 || c->versao != VERSAO_CACHE ||
+            c->tamCabecalho != sizeof(CabecalhoCache) || c->hashConteudo != hashEsperado ||
+            c->tamVertice != sizeof(Vertice) || c->tamAresta != sizeof(Aresta) ||
+            c->tamArco != sizeof(Arco) || c->tamServico != sizeof(Servico) ||
+            c->tamTotal != mapa->tamanho() || c->numNos < 0 || c->numChaves < 0 ||
+            c->chaveDeposito < 0 || c->chaveDeposito > c->numChaves)
+            return false;
+        // Cada seção precisa caber no arquivo antes de qualquer acesso; um cache danificado é só recriado
+        const uint64_t linhasMatriz = static_cast<uint64_t>(c->numChaves) + 1;
+        if (c->passoMatriz < linhasMatriz || c->passoMatriz > c->tamTotal / sizeof(long long) ||
+            !secaoCabe(c->offVertices, c->numVertices, sizeof(Vertice), c->tamTotal) ||
+            !secaoCabe(c->offArestas, c->numArestas, sizeof(Aresta), c->tamTotal) ||
+            !secaoCabe(c->offArcos, c->numArcos, sizeof(Arco), c->tamTotal) ||
+            !secaoCabe(c->offServicos, c->numServicos, sizeof(Servico), c->tamTotal) ||
+            !secaoCabe(c->offNoDaChave, linhasMatriz, sizeof(int), c->tamTotal) ||
+            !secaoCabe(c->offMatriz, linhasMatriz, c->passoMatriz * sizeof(long long), c->tamTotal))
+            return false;
+        // As chaves dos serviços indexam a matriz diretamente (0 = nó inválido)
+        const Servico *s = reinterpret_cast<const Servico *>(mapa->dados() + c->offServicos);
+        for (uint64_t i = 0; i < c->numServicos; ++i)
+        {
+            if (s[i].chaveU < 0 || s[i].chaveU > c->numChaves || s[i].chaveV < 0 || s[i].chaveV > c->numChaves)
+                return false;
+        }
+        arquivo = std::move(mapa);
+        cab = c;
+        return true;
+    }
+
+    const CabecalhoCache &cabecalho() const { return *cab; }
+
+    const Vertice *vertices() const { return secao<Vertice>(cab->offVertices); }
+    const Aresta *arestas() const { return secao<Aresta>(cab->offArestas); }
+    const Arco *arcos() const { return secao<Arco>(cab->offArcos); }
+    const Servico *servicos() const { return secao<Servico>(cab->offServicos); }
+    const int *noDaChave() const { return secao<int>(cab->offNoDaChave); }
+
+    VisaoMatrizDistancias distancias() const
+    {
+        return {secao<long long>(cab->offMatriz), static_cast<size_t>(cab->passoMatriz), cab->numChaves};
+    }
+
+    // Reconstrói o objeto Grafo (com a adjacência CSR) a partir dos vetores do cache.
+    // Só é necessário para algoritmos que percorrem o grafo; o construtivo usa apenas a matriz.
+    Grafo reconstruirGrafo() const
+    {
+        Grafo g(cab->numNos);
+        for (uint64_t i = 0; i < cab->numVertices; ++i)
+            g.adicionarVertice(vertices()[i].id, vertices()[i].demanda, vertices()[i].s_custo);
+        for (uint64_t i = 0; i < cab->numArestas; ++i)
+        {
+            const Aresta &a = arestas()[i];
+            g.adicionarAresta(a.origem, a.destino, a.custo, a.demanda, a.s_custo);
+        }
+        for (uint64_t i = 0; i < cab->numArcos; ++i)
+        {
+            const Arco &a = arcos()[i];
+            g.adicionarArco(a.origem, a.destino, a.custo, a.demanda, a.s_custo);
+        }
+        g.congelar();
+        return g;
+    }
+
+private:
+    // Seção de n elementos de tamElemento bytes a partir de offset, alinhada e dentro de tamTotal (sem overflow).
+    static bool secaoCabe(uint64_t offset, uint64_t n, uint64_t tamElemento, uint64_t tamTotal)
+    {
+        return offset % 64 == 0 && offset <= tamTotal && n <= (tamTotal - offset) / tamElemento;
+    }
+
+    template <typename T>
+    const T *secao(uint64_t offset) const { return reinterpret_cast<const T *>(arquivo->dados() + offset); }
+
+    unique_ptr<ArquivoMapeado> arquivo;
+    const CabecalhoCache *cab = nullptr;
+};
+
+#endif // CACHE_INSTANCIAS_HPP
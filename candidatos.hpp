@@ -0,0 +1,468 @@
+#ifndef CANDIDATOS_HPP
+#define CANDIDATOS_HPP
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#if defined(__AVX2__)
+#include <immintrin.h> // Gather e comparações de 64 bits na avaliação dos candidatos
+#endif
+
+#include "grafo.hpp"              // Servico
+#include "matriz_distancias.hpp"  // VisaoMatrizDistancias, LONGLONG_INF
+#include "oraculo_distancias.hpp" // LinhaDistancias
+
+using namespace std;
+
+// Tamanho padrão das listas de candidatos de cada nó-chave.
+const int TAMANHO_LISTA_CANDIDATOS = 32;
+// Número de consultas a partir de um nó-chave a partir do qual sua lista de candidatos é construída.
+const int CONSULTAS_PARA_CONSTRUIR_LISTA = 3;
+
+// Custo de atender um serviço a partir de uma posição e como ele é percorrido.
+struct AvaliacaoServico
+{
+    long long custo = LONGLONG_INF; // Deslocamento + travessia + custo do serviço (LONGLONG_INF = inalcançável)
+    int p1 = 0, p2 = 0;             // Nós de saída da tupla (S id, p1, p2)
+    bool invertido = false;         // Aresta percorrida de v para u
+    int posFinal = 0;               // Nó em que o veículo termina o serviço
+    int chavePosFinal = 0;          // posFinal como nó-chave
+};
+
+// Avalia um serviço a partir da linha de distâncias da posição atual (entre nós-chave).
+// Arestas são percorridas no sentido mais barato; em caso de empate, de u para v.
+AvaliacaoServico avaliarServico(const Servico &s, LinhaDistancias distPosAtual)
+{
+    AvaliacaoServico a;
+    if (s.tipo == Servico::Tipo::NO)
+    {
+        // Verifica validade do nó (chave 0 = inválido) e alcançabilidade
+        if (s.chaveU > 0 && distPosAtual[s.chaveU] != LONGLONG_INF)
+        {
+            a.custo = distPosAtual[s.chaveU] + s.custoServicoProprio;
+            a.p1 = a.p2 = a.posFinal = s.idNoOriginal;
+            a.chavePosFinal = s.chaveU;
+        }
+    }
+    else if (s.tipo == Servico::Tipo::ARESTA)
+    {
+        if (s.chaveU > 0 && s.chaveV > 0)
+        {
+            long long custoViaU = LONGLONG_INF, custoViaV = LONGLONG_INF;
+            // Opção 1: posAtual -> u -> v
+            if (distPosAtual[s.chaveU] != LONGLONG_INF)
+                custoViaU = distPosAtual[s.chaveU] + s.custoTravessia + s.custoServicoProprio;
+            // Opção 2: posAtual -> v -> u
+            if (distPosAtual[s.chaveV] != LONGLONG_INF)
+                custoViaV = distPosAtual[s.chaveV] + s.custoTravessia + s.custoServicoProprio;
+
+            if (custoViaU <= custoViaV && custoViaU != LONGLONG_INF)
+            {
+                a.custo = custoViaU;
+                a.p1 = s.uOriginal;
+                a.p2 = a.posFinal = s.vOriginal;
+                a.chavePosFinal = s.chaveV;
+            }
+            else if (custoViaV < custoViaU && custoViaV != LONGLONG_INF)
+            {
+                a.custo = custoViaV;
+                a.invertido = true;
+                a.p1 = s.vOriginal;
+                a.p2 = a.posFinal = s.uOriginal;
+                a.chavePosFinal = s.chaveU;
+            }
+        }
+    }
+    else
+    { // Tipo ARCO: deslocamento até a origem do arco
+        if (s.chaveU > 0 && s.chaveV > 0 && distPosAtual[s.chaveU] != LONGLONG_INF)
+        {
+            a.custo = distPosAtual[s.chaveU] + s.custoTravessia + s.custoServicoProprio;
+            a.p1 = s.uOriginal;
+            a.p2 = a.posFinal = s.vOriginal;
+            a.chavePosFinal = s.chaveV;
+        }
+    }
+    return a;
+}
+
+// Serviços em estrutura de vetores (SoA) para os laços que avaliam muitos serviços a partir de uma mesma
+// linha de distâncias: cada campo usado no custo fica em um vetor próprio e contíguo, em vez de percorrer
+// a struct Servico inteira. O custo é min(linha[chaveA], linha[chaveB]) + custoFixo, o mesmo de
+// avaliarServico (para nós e arcos, chaveA == chaveB). Serviços sem nós-chave válidos têm chaves 0, cuja
+// distância é sempre infinita. Requer chaveU/chaveV já preenchidos (construirNosChave).
+struct ServicosSoA
+{
+    vector<int> chaveA, chaveB;  // Nós-chave pelos quais o serviço pode começar
+    vector<int> demanda;
+    vector<long long> custoFixo; // Travessia (arestas e arcos) + custo do serviço
+
+    ServicosSoA() = default;
+    explicit ServicosSoA(const vector<Servico> &servicos)
+    {
+        const size_t n = servicos.size();
+        chaveA.resize(n);
+        chaveB.resize(n);
+        demanda.resize(n);
+        custoFixo.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Servico &s = servicos[i];
+            const bool valido = s.chaveU > 0 && (s.tipo == Servico::Tipo::NO || s.chaveV > 0);
+            chaveA[i] = valido ? s.chaveU : 0;
+            chaveB[i] = valido && s.tipo == Servico::Tipo::ARESTA ? s.chaveV : chaveA[i];
+            demanda[i] = s.demanda;
+            custoFixo[i] = s.tipo == Servico::Tipo::NO ? s.custoServicoProprio
+                                                       : static_cast<long long>(s.custoTravessia) + s.custoServicoProprio;
+        }
+    }
+
+    int tamanho() const { return static_cast<int>(demanda.size()); }
+
+    // Custo de atender o serviço i a partir da linha bruta da posição atual (LONGLONG_INF = inalcançável).
+    long long custo(int i, const long long *linha) const
+    {
+        const long long d = min(linha[chaveA[i]], linha[chaveB[i]]);
+        return d >= DIST_INF_SATURADO ? LONGLONG_INF : d + custoFixo[i];
+    }
+};
+
+// Serviços pendentes de um mesmo formato em vetores separados (SoA), com remoção por troca com o último.
+// Nós e arcos têm uma única entrada (chaveA); arestas têm duas (chaveA = u, chaveB = v) e são avaliadas pelo
+// sentido mais barato. Assim a avaliação de um grupo não depende do tipo de cada serviço.
+struct GrupoPendentes
+{
+    bool duasEntradas = false;
+    vector<int> indice;          // Índice do serviço em servicos
+    vector<int> demanda;
+    vector<int> chaveA, chaveB;  // chaveB só é usada com duasEntradas
+    vector<long long> custoFixo; // Travessia (arestas e arcos) + custo do serviço
+
+    int tamanho() const { return static_cast<int>(indice.size()); }
+
+    void adicionar(int i, int dem, int a, int b, long long fixo)
+    {
+        indice.push_back(i);
+        demanda.push_back(dem);
+        chaveA.push_back(a);
+        chaveB.push_back(b);
+        custoFixo.push_back(fixo);
+    }
+
+    // Remove a posição pos trocando-a com a última; retorna o índice do serviço que passou a ocupar pos.
+    int remover(int pos)
+    {
+        const int ultimo = tamanho() - 1;
+        indice[pos] = indice[ultimo];
+        demanda[pos] = demanda[ultimo];
+        chaveA[pos] = chaveA[ultimo];
+        chaveB[pos] = chaveB[ultimo];
+        custoFixo[pos] = custoFixo[ultimo];
+        indice.pop_back();
+        demanda.pop_back();
+        chaveA.pop_back();
+        chaveB.pop_back();
+        custoFixo.pop_back();
+        return pos < ultimo ? indice[pos] : -1;
+    }
+};
+
+// Custo de cada serviço do grupo a partir da linha bruta de distâncias: min das entradas + custoFixo, ou
+// LLONG_MAX se o serviço for inalcançável ou tiver demanda > limiteDemanda. Sem desvios: com AVX2, quatro
+// serviços por vez (gather das distâncias na linha, mínimo entre os sentidos e máscara de elegibilidade).
+void calcularCustosGrupo(const GrupoPendentes &g, const long long *linha, long long limiteDemanda,
+                         long long *__restrict custos)
+{
+    const int n = g.tamanho();
+    int j = 0;
+#if defined(__AVX2__)
+    const __m256i vLimite = _mm256_set1_epi64x(limiteDemanda);
+    const __m256i vInfMenos1 = _mm256_set1_epi64x(DIST_INF_SATURADO - 1);
+    const __m256i vMax = _mm256_set1_epi64x(LLONG_MAX);
+    for (; j + 4 <= n; j += 4)
+    {
+        __m256i d = _mm256_i32gather_epi64(linha, _mm_loadu_si128(reinterpret_cast<const __m128i *>(&g.chaveA[j])), 8);
+        if (g.duasEntradas)
+        {
+            __m256i dB = _mm256_i32gather_epi64(linha, _mm_loadu_si128(reinterpret_cast<const __m128i *>(&g.chaveB[j])), 8);
+            d = _mm256_blendv_epi8(d, dB, _mm256_cmpgt_epi64(d, dB));
+        }
+        __m256i dem = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&g.demanda[j])));
+        __m256i inelegivel = _mm256_or_si256(_mm256_cmpgt_epi64(dem, vLimite), _mm256_cmpgt_epi64(d, vInfMenos1));
+        __m256i custo = _mm256_add_epi64(d, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&g.custoFixo[j])));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(custos + j), _mm256_blendv_epi8(custo, vMax, inelegivel));
+    }
+#endif
+    for (; j < n; ++j)
+    {
+        const long long d = min(linha[g.chaveA[j]], linha[g.chaveB[j]]); // chaveB == chaveA com uma entrada
+        const bool elegivel = g.demanda[j] <= limiteDemanda && d < DIST_INF_SATURADO;
+        custos[j] = elegivel ? d + g.custoFixo[j] : LLONG_MAX;
+    }
+}
+
+// Posição do menor (custo, índice do serviço) entre custos[0..n), ou -1 se todos forem LLONG_MAX.
+// Com AVX2, mantém o melhor de cada uma das quatro faixas e as combina ao final.
+int posicaoMenorCusto(const long long *custos, const int *indice, int n)
+{
+    long long melhorCusto = LLONG_MAX;
+    int melhorIndice = INT_MAX, melhorPos = -1;
+    int j = 0;
+#if defined(__AVX2__)
+    if (n >= 4)
+    {
+        __m256i vCusto = _mm256_set1_epi64x(LLONG_MAX), vIndice = _mm256_set1_epi64x(INT_MAX);
+        __m256i vPos = _mm256_set1_epi64x(-1), vJ = _mm256_setr_epi64x(0, 1, 2, 3);
+        const __m256i vQuatro = _mm256_set1_epi64x(4);
+        for (; j + 4 <= n; j += 4, vJ = _mm256_add_epi64(vJ, vQuatro))
+        {
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(custos + j));
+            __m256i idx = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indice + j)));
+            __m256i melhor = _mm256_or_si256(_mm256_cmpgt_epi64(vCusto, c),
+                                             _mm256_and_si256(_mm256_cmpeq_epi64(vCusto, c), _mm256_cmpgt_epi64(vIndice, idx)));
+            vCusto = _mm256_blendv_epi8(vCusto, c, melhor);
+            vIndice = _mm256_blendv_epi8(vIndice, idx, melhor);
+            vPos = _mm256_blendv_epi8(vPos, vJ, melhor);
+        }
+        alignas(32) long long faixaCusto[4], faixaIndice[4], faixaPos[4];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(faixaCusto), vCusto);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(faixaIndice), vIndice);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(faixaPos), vPos);
+        for (int f = 0; f < 4; ++f)
+        {
+            if (faixaCusto[f] < melhorCusto || (faixaCusto[f] == melhorCusto && faixaIndice[f] < melhorIndice))
+            {
+                melhorCusto = faixaCusto[f];
+                melhorIndice = static_cast<int>(faixaIndice[f]);
+                melhorPos = static_cast<int>(faixaPos[f]);
+            }
+        }
+    }
+#endif
+    for (; j < n; ++j)
+    {
+        const bool melhor = custos[j] < melhorCusto || (custos[j] == melhorCusto && indice[j] < melhorIndice);
+        melhorCusto = melhor ? custos[j] : melhorCusto;
+        melhorIndice = melhor ? indice[j] : melhorIndice;
+        melhorPos = melhor ? j : melhorPos;
+    }
+    return melhorCusto == LLONG_MAX ? -1 : melhorPos;
+}
+
+// Índice granular de candidatos para a heurística construtiva. Os serviços pendentes ficam em grupos
+// compactos por formato (GrupoPendentes, remoção por troca com o último), de modo que cada busca percorre
+// apenas os que ainda faltam, avaliados sem desvios (calcularCustosGrupo).
+// Nós-chave consultados repetidamente (o depósito, a cada nova rota) ganham uma lista com os serviços
+// pendentes mais próximos, ordenados por (custo, índice). Serviços atendidos são removidos da lista de
+// forma preguiçosa (consultando um mapa de bits); quando uma lista truncada se esgota, ela é reconstruída.
+// Como a ordem é total e os serviços só deixam de estar pendentes, o primeiro candidato viável da lista é
+// exatamente o serviço que a busca completa escolheria (menor custo, menor índice em caso de empate).
+// Uma contagem de pendentes por demanda encerra a rota sem busca quando nenhum deles cabe no veículo.
+class IndiceCandidatos
+{
+public:
+    IndiceCandidatos(vector<Servico> &servicos_, VisaoMatrizDistancias dist_, int capacidadeVeiculo_,
+                     int tamanhoLista_ = TAMANHO_LISTA_CANDIDATOS)
+        : servicos(servicos_), dist(dist_), tamanhoLista(max(1, tamanhoLista_)),
+          capacidadeVeiculo(capacidadeVeiculo_), listas(dist_.numVertices() + 1), posPendente(servicos_.size(), -1),
+          atendidos((servicos_.size() + 63) / 64, 0)
+    {
+        grupos[GRUPO_DUAS_ENTRADAS].duasEntradas = true;
+        for (int i = 0; i < static_cast<int>(servicos.size()); ++i)
+        {
+            const Servico &s = servicos[i];
+            if (s.atendido)
+                atendidos[i >> 6] |= uint64_t(1) << (i & 63);
+            // Serviços sem nós-chave válidos ou maiores que o veículo nunca podem ser escolhidos
+            if (s.atendido || s.chaveU <= 0 || (s.tipo != Servico::Tipo::NO && s.chaveV <= 0) ||
+                s.demanda > capacidadeVeiculo)
+                continue;
+            GrupoPendentes &g = grupos[grupoDe(i)];
+            posPendente[i] = g.tamanho();
+            if (s.tipo == Servico::Tipo::ARESTA) // Arestas podem começar por qualquer extremidade
+                g.adicionar(i, s.demanda, s.chaveU, s.chaveV, static_cast<long long>(s.custoTravessia) + s.custoServicoProprio);
+            else if (s.tipo == Servico::Tipo::ARCO)
+                g.adicionar(i, s.demanda, s.chaveU, s.chaveU, static_cast<long long>(s.custoTravessia) + s.custoServicoProprio);
+            else
+                g.adicionar(i, s.demanda, s.chaveU, s.chaveU, s.custoServicoProprio);
+            pendentesPorDemanda[s.demanda]++;
+        }
+        rascunho.reserve(2 * static_cast<size_t>(tamanhoLista));
+    }
+
+    // Melhor serviço pendente com demanda <= capacidadeRestante a partir do nó-chave chavePos.
+    // Retorna o índice em servicos (e preenche aval) ou -1 se nenhum serviço puder ser atendido.
+    int melhorServico(int chavePos, long long capacidadeRestante, AvaliacaoServico &aval)
+    {
+        if (chavePos <= 0 || pendentesPorDemanda.empty() || pendentesPorDemanda.begin()->first > capacidadeRestante)
+            return -1;
+
+        // Nós pouco consultados usam a busca direta: a lista só compensa quando é reaproveitada
+        ListaCandidatos &lista = listas[chavePos];
+        if (!lista.construida && ++lista.numConsultas < CONSULTAS_PARA_CONSTRUIR_LISTA)
+            return buscarDireto(chavePos, capacidadeRestante, aval);
+        if (!lista.construida || capacidadeRestante > lista.limiteDemanda)
+            construirLista(chavePos, capacidadeVeiculo, lista);
+
+        while (true)
+        {
+            // Remoção preguiçosa dos atendidos no início da lista
+            while (lista.inicio < lista.entradas.size() && foiAtendido(lista.entradas[lista.inicio].indice))
+                lista.inicio++;
+
+            for (size_t e = lista.inicio; e < lista.entradas.size(); ++e)
+            {
+                const Candidato &c = lista.entradas[e];
+                if (!foiAtendido(c.indice) && c.demanda <= capacidadeRestante)
+                {
+                    aval = avaliarServico(servicos[c.indice], LinhaDistancias{dist.linha(chavePos)});
+                    return c.indice;
+                }
+            }
+            if (lista.completa)
+                return -1; // A lista continha todos os serviços alcançáveis: nenhum cabe
+            // Lista truncada esgotada: reconstrói apenas com os serviços que cabem agora
+            // (após isso a lista fica vazia e completa ou seu primeiro pendente é viável)
+            construirLista(chavePos, capacidadeRestante, lista);
+        }
+    }
+
+    // Marca o serviço como atendido.
+    void marcarAtendido(int indice)
+    {
+        Servico &s = servicos[indice];
+        s.atendido = true;
+        atendidos[indice >> 6] |= uint64_t(1) << (indice & 63);
+        int pos = posPendente[indice];
+        if (pos < 0)
+            return;
+        int movido = grupos[grupoDe(indice)].remover(pos);
+        if (movido >= 0)
+            posPendente[movido] = pos;
+        posPendente[indice] = -1;
+        auto it = pendentesPorDemanda.find(s.demanda);
+        if (--it->second == 0)
+            pendentesPorDemanda.erase(it);
+    }
+
+private:
+    static const int GRUPO_UMA_ENTRADA = 0;   // Nós e arcos
+    static const int GRUPO_DUAS_ENTRADAS = 1; // Arestas
+
+    struct Candidato
+    {
+        long long custo;
+        int indice;
+        int demanda; // Cópia da demanda do serviço, para a varredura da lista não consultar servicos
+
+        bool operator<(const Candidato &o) const { return custo != o.custo ? custo < o.custo : indice < o.indice; }
+    };
+
+    struct ListaCandidatos
+    {
+        vector<Candidato> entradas;
+        size_t inicio = 0;           // Entradas anteriores já foram atendidas
+        int numConsultas = 0;        // Consultas feitas antes de a lista ser construída
+        long long limiteDemanda = 0; // A lista só considera serviços com demanda <= limiteDemanda
+        bool construida = false;
+        bool completa = false;       // true se não houve truncamento (todos os pendentes alcançáveis estão na lista)
+    };
+
+    int grupoDe(int indice) const
+    {
+        return servicos[indice].tipo == Servico::Tipo::ARESTA ? GRUPO_DUAS_ENTRADAS : GRUPO_UMA_ENTRADA;
+    }
+
+    bool foiAtendido(int indice) const { return (atendidos[indice >> 6] >> (indice & 63)) & 1; }
+
+    // Custos de todos os pendentes do grupo em custosGrupo (ver calcularCustosGrupo).
+    const long long *custosDoGrupo(int grupo, const long long *linha, long long limiteDemanda)
+    {
+        vector<long long> &custos = custosGrupo[grupo];
+        custos.resize(grupos[grupo].tamanho());
+        calcularCustosGrupo(grupos[grupo], linha, limiteDemanda, custos.data());
+        return custos.data();
+    }
+
+    // Busca completa sobre os serviços pendentes, sem construir a lista do nó.
+    int buscarDireto(int chavePos, long long capacidadeRestante, AvaliacaoServico &aval)
+    {
+        const long long *linha = dist.linha(chavePos);
+        Candidato melhor{LLONG_MAX, INT_MAX, 0};
+        for (int grupo = 0; grupo < 2; ++grupo)
+        {
+            const GrupoPendentes &g = grupos[grupo];
+            const long long *custos = custosDoGrupo(grupo, linha, capacidadeRestante);
+            int pos = posicaoMenorCusto(custos, g.indice.data(), g.tamanho());
+            if (pos < 0)
+                continue;
+            Candidato c{custos[pos], g.indice[pos], g.demanda[pos]};
+            if (c < melhor)
+                melhor = c;
+        }
+        if (melhor.indice == INT_MAX)
+            return -1;
+        aval = avaliarServico(servicos[melhor.indice], LinhaDistancias{linha});
+        return melhor.indice;
+    }
+
+    // Avalia os serviços pendentes com demanda <= limiteDemanda a partir de chavePos e guarda os
+    // tamanhoLista mais baratos. A lista vale para consultas com capacidade restante <= limiteDemanda.
+    void construirLista(int chavePos, long long limiteDemanda, ListaCandidatos &lista)
+    {
+        // Seleção limitada: rascunho acumula candidatos abaixo do limiar e é podado para os tamanhoLista
+        // melhores sempre que dobra de tamanho; a maioria dos serviços é descartada com uma comparação
+        const long long *linha = dist.linha(chavePos);
+        rascunho.clear();
+        Candidato limiar{LLONG_MAX, INT_MAX, 0};
+        size_t numElegiveis = 0;
+        for (int grupo = 0; grupo < 2; ++grupo)
+        {
+            const GrupoPendentes &g = grupos[grupo];
+            const long long *custos = custosDoGrupo(grupo, linha, limiteDemanda);
+            for (int p = 0; p < g.tamanho(); ++p)
+            {
+                if (custos[p] == LLONG_MAX)
+                    continue;
+                numElegiveis++;
+                Candidato c{custos[p], g.indice[p], g.demanda[p]};
+                if (!(c < limiar))
+                    continue;
+                rascunho.push_back(c);
+                if (rascunho.size() == 2 * static_cast<size_t>(tamanhoLista))
+                {
+                    nth_element(rascunho.begin(), rascunho.begin() + (tamanhoLista - 1), rascunho.end());
+                    rascunho.resize(tamanhoLista);
+                    limiar = rascunho.back();
+                }
+            }
+        }
+        if (rascunho.size() > static_cast<size_t>(tamanhoLista))
+        {
+            nth_element(rascunho.begin(), rascunho.begin() + (tamanhoLista - 1), rascunho.end());
+            rascunho.resize(tamanhoLista);
+        }
+        sort(rascunho.begin(), rascunho.end());
+        lista.completa = numElegiveis <= static_cast<size_t>(tamanhoLista);
+        lista.entradas.assign(rascunho.begin(), rascunho.end());
+        lista.inicio = 0;
+        lista.limiteDemanda = limiteDemanda;
+        lista.construida = true;
+    }
+
+    vector<Servico> &servicos;
+    VisaoMatrizDistancias dist;
+    int tamanhoLista;
+    int capacidadeVeiculo;
+    vector<ListaCandidatos> listas;    // Indexadas pelo nó-chave
+    vector<Candidato> rascunho;        // Área de trabalho de construirLista
+    GrupoPendentes grupos[2];          // Serviços ainda não atendidos que podem ser escolhidos, por formato
+    vector<long long> custosGrupo[2];  // Área de trabalho: custos de cada grupo a partir da posição atual
+    vector<int> posPendente;           // Índice do serviço -> posição no seu grupo (-1 se não estiver lá)
+    vector<uint64_t> atendidos;        // Mapa de bits dos serviços já atendidos
+    map<int, int> pendentesPorDemanda; // Demanda -> número de serviços pendentes com essa demanda
+};
+
+#endif // CANDIDATOS_HPP
@@ -0,0 +1,114 @@
+#ifndef CONSTRUTIVO_HPP
+#define CONSTRUTIVO_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "grafo.hpp"      // Servico
+#include "preparacao.hpp" // InstanciaPreparada
+#include "candidatos.hpp" // IndiceCandidatos, AvaliacaoServico
+#include "solucao.hpp"    // Solucao, Rota, Visita
+
+using namespace std;
+
+// Algoritmo Construtivo Guloso (vizinho mais próximo): cada rota parte do depósito e recebe, enquanto
+// couber no veículo, o serviço pendente mais barato a partir da posição atual (deslocamento + serviço).
+// Marca os serviços atendidos em inst.servicos. Alertas vão para os fluxos saida/erros.
+Solucao construirSolucaoGulosa(InstanciaPreparada &inst, int tamanhoListaCandidatos, ostream &saida, ostream &erros)
+{
+    vector<Servico> &listaTodosServicos = inst.servicos;
+    Solucao solucao;
+    int idProximaRotaValida = 1; // ID para a próxima rota válida a ser gerada
+    int servicosAtendidosCont = 0;
+    int totalServicosRequeridos = listaTodosServicos.size();
+
+    if (totalServicosRequeridos == 0)
+    {
+        saida << "Instancia " << inst.nomeInstancia << " nao possui servicos requeridos." << endl;
+        return solucao;
+    }
+
+    // Listas granulares dos serviços pendentes mais próximos de cada nó-chave
+    IndiceCandidatos indiceCandidatos(listaTodosServicos, inst.distChaves, inst.capacidadeVeiculo, tamanhoListaCandidatos);
+    int servicosAtendidosNaIteracaoAnterior; // Para salvaguarda contra loop infinito
+    // Loop principal de construção de rotas: continua enquanto houver serviços não atendidos
+    while (servicosAtendidosCont < totalServicosRequeridos)
+    {
+        servicosAtendidosNaIteracaoAnterior = servicosAtendidosCont;
+
+        // Inicializa uma nova rota no depósito
+        Rota rotaAtual;
+        int posAtualVeiculo = inst.idNoDeposito;
+        int chavePosAtual = inst.chaveDeposito; // Posição do veículo como nó-chave
+
+        bool podeAdicionarMaisServicosARota = true;
+        // Loop interno: adiciona serviços à rota atual enquanto possível
+        while (podeAdicionarMaisServicosARota)
+        {
+            // Melhor serviço pendente (menor custo de deslocamento + serviço) que cabe na capacidade restante
+            AvaliacaoServico melhorAvaliacao;
+            int melhorIndiceServicoParaAdicionar = indiceCandidatos.melhorServico(
+                chavePosAtual, inst.capacidadeVeiculo - rotaAtual.demanda, melhorAvaliacao);
+
+            // Se um serviço viável foi encontrado, adiciona-o à rota
+            if (melhorIndiceServicoParaAdicionar != -1)
+            {
+                const Servico &servEscolhido = listaTodosServicos[melhorIndiceServicoParaAdicionar];
+                indiceCandidatos.marcarAtendido(melhorIndiceServicoParaAdicionar);
+                servicosAtendidosCont++;
+
+                rotaAtual.demanda += servEscolhido.demanda;
+                rotaAtual.custo += melhorAvaliacao.custo; // Adiciona custo total (deslocamento + serviço)
+                rotaAtual.visitas.push_back({melhorIndiceServicoParaAdicionar, melhorAvaliacao.invertido});
+                posAtualVeiculo = melhorAvaliacao.posFinal; // Atualiza posição do veículo
+                chavePosAtual = melhorAvaliacao.chavePosFinal;
+            }
+            else
+            {
+                // Nenhum serviço pode ser adicionado (capacidade, todos atendidos, inalcançável)
+                podeAdicionarMaisServicosARota = false;
+            }
+        } // Fim do loop de adicionar serviços à rota atual
+
+        // Finaliza a rota: calcula custo de retorno ao depósito
+        if (posAtualVeiculo != inst.idNoDeposito &&
+            (chavePosAtual > 0 && inst.chaveDeposito > 0 &&
+             inst.distChaves(chavePosAtual, inst.chaveDeposito) != LONGLONG_INF))
+        {
+            rotaAtual.custo += inst.distChaves(chavePosAtual, inst.chaveDeposito);
+        }
+        else if (posAtualVeiculo != inst.idNoDeposito)
+        {
+            erros << "ALERTA: Rota (ID proximo: " << idProximaRotaValida << ") para " << inst.nomeInstancia
+                  << " nao pode retornar ao deposito do no " << posAtualVeiculo << "." << endl;
+        }
+
+        // Armazena a rota na solução se ela atendeu pelo menos um serviço
+        if (!rotaAtual.visitas.empty())
+        {
+            solucao.custoTotal += rotaAtual.custo;
+            solucao.rotas.push_back(std::move(rotaAtual));
+            idProximaRotaValida++; // Incrementa ID para a próxima rota válida
+        }
+
+        // Salvaguarda: se nenhum serviço foi adicionado nesta iteração e ainda há serviços pendentes, para.
+        if (servicosAtendidosCont == servicosAtendidosNaIteracaoAnterior && servicosAtendidosCont < totalServicosRequeridos)
+        {
+            saida << "Alerta: Nenhum servico adicional pode ser atendido para " << inst.nomeInstancia
+                  << ". Servicos atendidos: " << servicosAtendidosCont << "/" << totalServicosRequeridos
+                  << ". Parando." << endl;
+            break; // Sai do loop 'while (servicosAtendidosCont < totalServicosRequeridos)'
+        }
+    } // Fim do loop principal de construção de rotas
+
+    // Mensagem final se nem todos os serviços foram atendidos
+    if (servicosAtendidosCont < totalServicosRequeridos)
+    {
+        saida << "Alerta Final: Para " << inst.nomeInstancia << ", nem todos os servicos foram atendidos. "
+              << "Atendidos: " << servicosAtendidosCont << "/" << totalServicosRequeridos << endl;
+    }
+    return solucao;
+}
+
+#endif // CONSTRUTIVO_HPP
@@ -0,0 +1,318 @@
+#ifndef DESCOMPACTACAO_HPP
+#define DESCOMPACTACAO_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <new>
+#include <algorithm>
+
+using namespace std;
+
+// Descompactador DEFLATE (RFC 1951) autocontido, usado para ler membros de arquivos .zip sem
+// depender de bibliotecas externas. Segue a estrutura clássica de decodificação canônica de Huffman.
+
+// Tabela de Huffman canônica: quantidade de códigos por comprimento e símbolos ordenados por código.
+struct TabelaHuffman
+{
+    short contagem[16];
+    short simbolos[288];
+};
+
+// Reserva máxima feita antecipadamente com o tamanho declarado no .zip; acima disso a saída cresce sob demanda
+// (o tamanho declarado pode estar corrompido e chegar a 4 GB).
+const size_t RESERVA_MAXIMA_DESCOMPACTACAO = size_t(64) << 20;
+
+class Inflador
+{
+public:
+    Inflador(const uint8_t *entrada_, size_t tamEntrada_, vector<char> &saida_, size_t limiteSaida_)
+        : entrada(entrada_), tamEntrada(tamEntrada_), saida(saida_), limiteSaida(limiteSaida_) {}
+
+    // Descompacta todo o fluxo DEFLATE. Lança runtime_error se os dados estiverem corrompidos
+    // ou se a saída passar de limiteSaida bytes.
+    void descompactar()
+    {
+        int ultimo;
+        do
+        {
+            ultimo = bits(1);
+            int tipo = bits(2);
+            if (tipo == 0)
+                blocoArmazenado();
+            else if (tipo == 1)
+                blocoFixo();
+            else if (tipo == 2)
+                blocoDinamico();
+            else
+                throw runtime_error("tipo de bloco DEFLATE invalido");
+        } while (!ultimo);
+    }
+
+private:
+    // Lê 'quantos' bits do fluxo (bit menos significativo primeiro).
+    int bits(int quantos)
+    {
+        uint32_t valor = bufferBits;
+        while (bitsNoBuffer < quantos)
+        {
+            if (posEntrada == tamEntrada)
+                throw runtime_error("fim inesperado dos dados compactados");
+            valor |= static_cast<uint32_t>(entrada[posEntrada++]) << bitsNoBuffer;
+            bitsNoBuffer += 8;
+        }
+        bufferBits = valor >> quantos;
+        bitsNoBuffer -= quantos;
+        return static_cast<int>(valor & ((1u << quantos) - 1));
+    }
+
+    // Interrompe antes de acrescentar 'quantos' bytes que levariam a saída além do limite.
+    void verificarLimite(size_t quantos) const
+    {
+        if (quantos > limiteSaida - saida.size())
+            throw runtime_error("dados descompactados maiores que o tamanho declarado");
+    }
+
+    // Monta a tabela a partir dos comprimentos de código de cada símbolo.
+    static void construirTabela(TabelaHuffman &t, const short *comprimentos, int numSimbolos)
+    {
+        for (int len = 0; len < 16; ++len)
+            t.contagem[len] = 0;
+        for (int s = 0; s < numSimbolos; ++s)
+            t.contagem[comprimentos[s]]++;
+
+        int restantes = 1;
+        for (int len = 1; len < 16; ++len)
+        {
+            restantes = (restantes << 1) - t.contagem[len];
+            if (restantes < 0)
+                throw runtime_error("codigo de Huffman com excesso de simbolos");
+        }
+
+        short deslocamento[16];
+        deslocamento[1] = 0;
+        for (int len = 1; len < 15; ++len)
+            deslocamento[len + 1] = deslocamento[len] + t.contagem[len];
+        for (int s = 0; s < numSimbolos; ++s)
+        {
+            if (comprimentos[s] != 0)
+                t.simbolos[deslocamento[comprimentos[s]]++] = static_cast<short>(s);
+        }
+    }
+
+    // Decodifica um símbolo percorrendo os comprimentos de código em ordem crescente.
+    int decodificar(const TabelaHuffman &t)
+    {
+        int codigo = 0, primeiro = 0, indice = 0;
+        for (int len = 1; len < 16; ++len)
+        {
+            codigo |= bits(1);
+            int quantidade = t.contagem[len];
+            if (codigo - quantidade < primeiro)
+                return t.simbolos[indice + (codigo - primeiro)];
+            indice += quantidade;
+            primeiro = (primeiro + quantidade) << 1;
+            codigo <<= 1;
+        }
+        throw runtime_error("codigo de Huffman invalido");
+    }
+
+    void blocoArmazenado()
+    {
+        bufferBits = 0; // Descarta os bits restantes do byte atual
+        bitsNoBuffer = 0;
+        if (posEntrada + 4 > tamEntrada)
+            throw runtime_error("bloco armazenado truncado");
+        unsigned len = entrada[posEntrada] | (entrada[posEntrada + 1] << 8);
+        unsigned nlen = entrada[posEntrada + 2] | (entrada[posEntrada + 3] << 8);
+        posEntrada += 4;
+        if (len != (~nlen & 0xffffu) || posEntrada + len > tamEntrada)
+            throw runtime_error("bloco armazenado invalido");
+        verificarLimite(len);
+        saida.insert(saida.end(), entrada + posEntrada, entrada + posEntrada + len);
+        posEntrada += len;
+    }
+
+    void decodificarBloco(const TabelaHuffman &tabLiterais, const TabelaHuffman &tabDistancias)
+    {
+        static const short baseComprimento[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const short extraComprimento[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                   3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const short baseDistancia[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                                193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                                6145, 8193, 12289, 16385, 24577};
+        static const short extraDistancia[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        while (true)
+        {
+            int simbolo = decodificar(tabLiterais);
+            if (simbolo < 256)
+            {
+                verificarLimite(1);
+                saida.push_back(static_cast<char>(simbolo));
+            }
+            else if (simbolo == 256)
+            {
+                return; // Fim do bloco
+            }
+            else
+            {
+                simbolo -= 257;
+                if (simbolo >= 29)
+                    throw runtime_error("simbolo de comprimento invalido");
+                int comprimento = baseComprimento[simbolo] + bits(extraComprimento[simbolo]);
+                int simboloDist = decodificar(tabDistancias);
+                if (simboloDist >= 30)
+                    throw runtime_error("simbolo de distancia invalido");
+                size_t distancia = baseDistancia[simboloDist] + bits(extraDistancia[simboloDist]);
+                if (distancia > saida.size())
+                    throw runtime_error("distancia alem do inicio da saida");
+                verificarLimite(comprimento);
+                size_t origem = saida.size() - distancia;
+                for (int i = 0; i < comprimento; ++i)
+                    saida.push_back(saida[origem + i]); // Cópias podem se sobrepor (distancia < comprimento)
+            }
+        }
+    }
+
+    void blocoFixo()
+    {
+        static TabelaHuffman tabLiterais, tabDistancias;
+        static bool construidas = [&]
+        {
+            short comprimentos[288];
+            int s = 0;
+            for (; s < 144; ++s)
+                comprimentos[s] = 8;
+            for (; s < 256; ++s)
+                comprimentos[s] = 9;
+            for (; s < 280; ++s)
+                comprimentos[s] = 7;
+            for (; s < 288; ++s)
+                comprimentos[s] = 8;
+            construirTabela(tabLiterais, comprimentos, 288);
+            for (s = 0; s < 30; ++s)
+                comprimentos[s] = 5;
+            construirTabela(tabDistancias, comprimentos, 30);
+            return true;
+        }();
+        (void)construidas;
+        decodificarBloco(tabLiterais, tabDistancias);
+    }
+
+    void blocoDinamico()
+    {
+        static const short ordem[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        int numLiterais = bits(5) + 257;
+        int numDistancias = bits(5) + 1;
+        int numCodigos = bits(4) + 4;
+        if (numLiterais > 286 || numDistancias > 30)
+            throw runtime_error("cabecalho de bloco dinamico invalido");
+
+        short comprimentos[320] = {0};
+        for (int i = 0; i < numCodigos; ++i)
+            comprimentos[ordem[i]] = static_cast<short>(bits(3));
+        TabelaHuffman tabComprimentos;
+        construirTabela(tabComprimentos, comprimentos, 19);
+
+        int i = 0;
+        while (i < numLiterais + numDistancias)
+        {
+            int simbolo = decodificar(tabComprimentos);
+            if (simbolo < 16)
+            {
+                comprimentos[i++] = static_cast<short>(simbolo);
+                continue;
+            }
+            short valor = 0;
+            int repeticoes;
+            if (simbolo == 16)
+            {
+                if (i == 0)
+                    throw runtime_error("repeticao sem comprimento anterior");
+                valor = comprimentos[i - 1];
+                repeticoes = 3 + bits(2);
+            }
+            else if (simbolo == 17)
+                repeticoes = 3 + bits(3);
+            else
+                repeticoes = 11 + bits(7);
+            if (i + repeticoes > numLiterais + numDistancias)
+                throw runtime_error("comprimentos de codigo em excesso");
+            while (repeticoes--)
+                comprimentos[i++] = valor;
+        }
+        if (comprimentos[256] == 0)
+            throw runtime_error("bloco sem codigo de fim");
+
+        TabelaHuffman tabLiterais, tabDistancias;
+        construirTabela(tabLiterais, comprimentos, numLiterais);
+        construirTabela(tabDistancias, comprimentos + numLiterais, numDistancias);
+        decodificarBloco(tabLiterais, tabDistancias);
+    }
+
+    const uint8_t *entrada;
+    size_t tamEntrada;
+    size_t posEntrada = 0;
+    uint32_t bufferBits = 0;
+    int bitsNoBuffer = 0;
+    vector<char> &saida;
+    size_t limiteSaida;
+};
+
+// CRC-32 (polinômio 0xEDB88320), usado para validar os membros descompactados do .zip.
+uint32_t calcularCrc32(const char *dados, size_t tamanho)
+{
+    static uint32_t tabela[256];
+    static bool construida = []
+    {
+        for (uint32_t n = 0; n < 256; ++n)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            tabela[n] = c;
+        }
+        return true;
+    }();
+    (void)construida;
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < tamanho; ++i)
+        crc = tabela[(crc ^ static_cast<uint8_t>(dados[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Descompacta um fluxo DEFLATE bruto em saida (que é substituída). Retorna false e preenche erro se falhar,
+// se a saída passar de tamEsperado (interrompendo assim que o limite é ultrapassado) ou se ficar menor que ele.
+bool descompactarDeflate(const uint8_t *entrada, size_t tamEntrada, size_t tamEsperado, vector<char> &saida, string &erro)
+{
+    saida.clear();
+    try
+    {
+        saida.reserve(min(tamEsperado, RESERVA_MAXIMA_DESCOMPACTACAO));
+        Inflador inflador(entrada, tamEntrada, saida, tamEsperado);
+        inflador.descompactar();
+    }
+    catch (const runtime_error &e)
+    {
+        erro = e.what();
+        return false;
+    }
+    catch (const bad_alloc &)
+    {
+        erro = "memoria insuficiente para descompactar";
+        return false;
+    }
+    if (saida.size() != tamEsperado)
+    {
+        erro = "dados descompactados menores que o tamanho declarado";
+        return false;
+    }
+    return true;
+}
+
+#endif // DESCOMPACTACAO_HPP
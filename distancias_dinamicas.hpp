@@ -0,0 +1,248 @@
+#ifndef DISTANCIAS_DINAMICAS_HPP
+#define DISTANCIAS_DINAMICAS_HPP
+
+#include <vector>
+#include <algorithm>
+
+#include "grafo.hpp"              // Grafo, Aresta, Arco, Servico
+#include "matriz_distancias.hpp"  // MatrizDistancias, relaxarLinha, DIST_INF_SATURADO
+#include "funcoes.hpp"            // floydWarshall
+#include "oraculo_distancias.hpp" // dijkstraUmaOrigem
+#include "nos_chave.hpp"          // NosChave
+
+using namespace std;
+
+// Caminhos mínimos entre todos os pares mantidos sob alterações do grafo (custos de vias que mudam ao longo
+// do dia, interdições e novas ligações), sem refazer o Floyd-Warshall O(V^3) a cada mudança:
+//   - redução de custo ou nova ligação a->b de custo c: d(i,j) = min(d(i,j), d(i,a) + c + d(b,j)) para todos os
+//     pares, em O(V^2), com o mesmo núcleo de relaxação de linhas do Floyd-Warshall (relaxarLinha);
+//   - aumento de custo ou remoção: apenas as origens i com algum par (i,j) cujo caminho mínimo pode usar a
+//     ligação (d(i,a) + c_antigo + d(b,j) = d(i,j)) têm a linha recalculada, com Dijkstra sobre o grafo já
+//     alterado; as demais linhas não mudam.
+// Arestas são tratadas como as duas ligações a->b e b->a. A matriz entre nós-chave e os custos de travessia
+// dos serviços podem ser atualizados a partir da matriz completa, e as rotas existentes recalculadas com
+// recalcularSolucao (solucao.hpp), sem reconstruir a instância.
+
+enum class TipoLigacao
+{
+    ARESTA,
+    ARCO
+};
+
+// Resumo de uma atualização: quantas linhas da matriz foram recalculadas por Dijkstra (0 nas reduções).
+struct ResultadoAtualizacao
+{
+    bool aplicada = false;
+    int linhasRecalculadas = 0;
+};
+
+class DistanciasDinamicas
+{
+public:
+    // Copia o grafo e calcula a matriz completa (64 bits: os custos podem crescer além do limite de 32 bits).
+    DistanciasDinamicas(const Grafo &g_, const ConfigFloydWarshall &configFW = ConfigFloydWarshall())
+        : g(g_), dist(floydWarshall(g_, configFW)), distTemp(g_.V + 1) {}
+
+    const Grafo &grafo() const { return g; }
+    const MatrizDistancias &matriz() const { return dist; }
+
+    // Altera o custo da primeira ligação do tipo dado entre origem e destino (para arestas, em qualquer ordem).
+    ResultadoAtualizacao alterarCusto(TipoLigacao tipo, int origem, int destino, int novoCusto)
+    {
+        ResultadoAtualizacao r;
+        int idx = encontrarLigacao(tipo, origem, destino);
+        if (idx < 0 || novoCusto < 0)
+            return r;
+        int &custo = custoLigacao(tipo, idx);
+        if (novoCusto <= custo)
+        {
+            custo = novoCusto;
+            g.congelar();
+            relaxarLigacao(tipo, origem, destino, novoCusto);
+        }
+        else
+        {
+            vector<int> afetadas = origensAfetadas(tipo, origem, destino, custo);
+            custo = novoCusto;
+            g.congelar();
+            r.linhasRecalculadas = recalcularLinhas(afetadas);
+        }
+        r.aplicada = true;
+        return r;
+    }
+
+    // Acrescenta uma ligação não requerida (demanda 0).
+    ResultadoAtualizacao adicionarLigacao(TipoLigacao tipo, int origem, int destino, int custo)
+    {
+        ResultadoAtualizacao r;
+        if (!valido(origem) || !valido(destino) || custo < 0)
+            return r;
+        if (tipo == TipoLigacao::ARESTA)
+            g.adicionarAresta(origem, destino, custo, 0, 0);
+        else
+            g.adicionarArco(origem, destino, custo, 0, 0);
+        g.congelar();
+        relaxarLigacao(tipo, origem, destino, custo);
+        r.aplicada = true;
+        return r;
+    }
+
+    // Remove a primeira ligação do tipo dado entre origem e destino. Ligações requeridas (serviços) não são
+    // removidas por aqui: a lista de serviços e as soluções dependem delas.
+    ResultadoAtualizacao removerLigacao(TipoLigacao tipo, int origem, int destino)
+    {
+        ResultadoAtualizacao r;
+        int idx = encontrarLigacao(tipo, origem, destino);
+        if (idx < 0)
+            return r;
+        bool requerida = tipo == TipoLigacao::ARESTA ? g.arestas[idx].demanda > 0 : g.arcos[idx].demanda > 0;
+        if (requerida)
+            return r;
+        vector<int> afetadas = origensAfetadas(tipo, origem, destino, custoLigacao(tipo, idx));
+        if (tipo == TipoLigacao::ARESTA)
+            g.arestas.erase(g.arestas.begin() + idx);
+        else
+            g.arcos.erase(g.arcos.begin() + idx);
+        g.congelar();
+        r.linhasRecalculadas = recalcularLinhas(afetadas);
+        r.aplicada = true;
+        return r;
+    }
+
+    // Copia para a matriz entre nós-chave as distâncias atuais (O(K^2)).
+    void atualizarNosChave(NosChave &nos) const
+    {
+        const int K = nos.numChaves();
+        for (int x = 1; x <= K; ++x)
+        {
+            const long long *origem = dist.linha(nos.noDaChave[x]);
+            long long *destino = nos.dist.linha(x);
+            for (int y = 1; y <= K; ++y)
+                destino[y] = origem[nos.noDaChave[y]];
+        }
+    }
+
+    // Atualiza o custo de travessia dos serviços de arestas e arcos com os custos atuais das ligações
+    // requeridas (a lista de serviços segue a ordem das ligações requeridas no grafo, ver montarListaServicos).
+    void atualizarCustosServicos(vector<Servico> &servicos) const
+    {
+        size_t ia = 0, ib = 0;
+        for (Servico &s : servicos)
+        {
+            if (s.tipo == Servico::Tipo::ARESTA)
+            {
+                while (ia < g.arestas.size() && g.arestas[ia].demanda <= 0)
+                    ia++;
+                if (ia < g.arestas.size())
+                    s.custoTravessia = g.arestas[ia++].custo;
+            }
+            else if (s.tipo == Servico::Tipo::ARCO)
+            {
+                while (ib < g.arcos.size() && g.arcos[ib].demanda <= 0)
+                    ib++;
+                if (ib < g.arcos.size())
+                    s.custoTravessia = g.arcos[ib++].custo;
+            }
+        }
+    }
+
+private:
+    bool valido(int no) const { return no > 0 && no <= g.V; }
+
+    // Índice da ligação em g.arestas ou g.arcos (-1 se não existir).
+    int encontrarLigacao(TipoLigacao tipo, int origem, int destino) const
+    {
+        if (!valido(origem) || !valido(destino))
+            return -1;
+        if (tipo == TipoLigacao::ARESTA)
+        {
+            for (size_t k = 0; k < g.arestas.size(); ++k)
+            {
+                const Aresta &e = g.arestas[k];
+                if ((e.origem == origem && e.destino == destino) || (e.origem == destino && e.destino == origem))
+                    return static_cast<int>(k);
+            }
+        }
+        else
+        {
+            for (size_t k = 0; k < g.arcos.size(); ++k)
+            {
+                if (g.arcos[k].origem == origem && g.arcos[k].destino == destino)
+                    return static_cast<int>(k);
+            }
+        }
+        return -1;
+    }
+
+    int &custoLigacao(TipoLigacao tipo, int idx)
+    {
+        return tipo == TipoLigacao::ARESTA ? g.arestas[idx].custo : g.arcos[idx].custo;
+    }
+
+    // Redução: relaxa todos os pares pela ligação a->b (e b->a para arestas), linha a linha.
+    void relaxarLigacao(TipoLigacao tipo, int a, int b, long long c)
+    {
+        relaxarDirecao(a, b, c);
+        if (tipo == TipoLigacao::ARESTA)
+            relaxarDirecao(b, a, c);
+    }
+
+    void relaxarDirecao(int a, int b, long long c)
+    {
+        const int n = dist.numVertices();
+        const long long *linhaB = dist.linha(b);
+        for (int i = 1; i <= n; ++i)
+        {
+            const long long dia = dist.bruto(i, a);
+            if (i == b || dia >= DIST_INF_SATURADO)
+                continue; // A linha de b não muda (d(b,a) + c >= 0), por isso pode ser lida durante o laço
+            relaxarLinha(dist.linha(i) + 1, linhaB + 1, dia + c, n);
+        }
+    }
+
+    // Origens cujas linhas podem mudar se a ligação a->b (e b->a, para arestas) de custo c ficar mais cara
+    // ou deixar de existir. Usa a matriz ainda não alterada.
+    vector<int> origensAfetadas(TipoLigacao tipo, int a, int b, long long c) const
+    {
+        const int n = dist.numVertices();
+        vector<int> afetadas;
+        for (int i = 1; i <= n; ++i)
+        {
+            if (usaLigacao(i, a, b, c) || (tipo == TipoLigacao::ARESTA && usaLigacao(i, b, a, c)))
+                afetadas.push_back(i);
+        }
+        return afetadas;
+    }
+
+    // Algum caminho mínimo a partir de i pode passar por a->b com custo c?
+    bool usaLigacao(int i, int a, int b, long long c) const
+    {
+        const long long dia = dist.bruto(i, a);
+        if (dia >= DIST_INF_SATURADO)
+            return false;
+        const int n = dist.numVertices();
+        const long long *linhaI = dist.linha(i), *linhaB = dist.linha(b);
+        for (int j = 1; j <= n; ++j)
+        {
+            if (linhaB[j] < DIST_INF_SATURADO && dia + c + linhaB[j] == linhaI[j])
+                return true;
+        }
+        return false;
+    }
+
+    int recalcularLinhas(const vector<int> &origens)
+    {
+        for (int i : origens)
+        {
+            dijkstraUmaOrigem(g, i, distTemp.data());
+            copy(distTemp.begin(), distTemp.end(), dist.linha(i));
+        }
+        return static_cast<int>(origens.size());
+    }
+
+    Grafo g;
+    MatrizDistancias dist;
+    vector<long long> distTemp;
+};
+
+#endif // DISTANCIAS_DINAMICAS_HPP
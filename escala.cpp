@@ -0,0 +1,385 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+#include "grafo.hpp"               // DadosInstancia
+#include "leitura_rapida.hpp"      // lerGrafoMapeado
+#include "oraculo_distancias.hpp"  // criarOraculoDistancias
+#include "nos_chave.hpp"           // construirNosChave
+#include "preparacao.hpp"          // montarListaServicos, InstanciaPreparada
+#include "construtivo.hpp"         // construirSolucaoGulosa
+#include "busca_local.hpp"         // BuscaLocal
+#include "opcoes.hpp"              // lerArgumentoInteiro, lerArgumentoReal
+#include "gerador_instancias.hpp"  // gerarInstancia, escreverInstancia
+
+using namespace std;
+
+// Benchmark de escala: gera instâncias sintéticas de tamanhos crescentes (gerador_instancias.hpp), grava cada
+// uma em .dat e mede, fase a fase, o tempo e o pico de memória do processo (geração, leitura, Floyd-Warshall,
+// nós-chave, construtivo e, opcionalmente, busca local). O Floyd-Warshall só roda até --max-nos-fw nós e fases
+// cuja matriz estimada passa de --memoria-max são puladas; ambas ficam registradas no CSV, para mostrar onde
+// cada etapa deixa de caber.
+// Compilação: g++ -std=c++17 -O2 -march=native escala.cpp -o escala -pthread
+
+struct OpcoesEscala
+{
+    string pastaSaida = "instancias_sinteticas";
+    vector<int> tamanhos = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+    string arquivoCsv = "escala.csv";
+    ConfigGerador gerador;
+    double memoriaMaxMB = 4096;  // Maior matriz (VxV ou KxK) alocada por uma fase
+    int maxNosFW = 10000;        // Maior instância em que o Floyd-Warshall O(V^3) é executado
+    bool buscaLocal = false;
+    bool apenasGerar = false;
+    ConfigFloydWarshall configFW;
+};
+
+// Pico de memória residente do processo (MB) desde o último reiniciarPicoMemoria. No Linux o pico é reiniciado
+// a cada fase (/proc/self/clear_refs); nos demais sistemas é o pico desde o início do processo.
+void reiniciarPicoMemoria()
+{
+#ifdef __linux__
+    ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+double picoMemoriaMB()
+{
+#ifdef __linux__
+    ifstream status("/proc/self/status");
+    string linha;
+    while (getline(status, linha))
+    {
+        if (linha.rfind("VmHWM:", 0) == 0)
+            return atof(linha.c_str() + 6) / 1024.0; // Valor em kB
+    }
+    return 0;
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.PeakWorkingSetSize / (1024.0 * 1024.0);
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+// Uma linha do CSV: tamanho da instância, fase, tempo, pico de memória e observação (ex.: fase pulada).
+struct MedicaoFase
+{
+    int nos = 0, arestas = 0, arcos = 0, servicos = 0;
+    string fase;
+    double segundos = 0;
+    double picoMB = 0;
+    string observacao;
+};
+
+void imprimirUsoEscala(const char *nomePrograma)
+{
+    cout << "Uso: " << nomePrograma << " [pasta_saida] [opcoes]\n"
+         << "  --tamanhos A,B,...     Numeros de nos das instancias geradas (padrao 1000,...,100000)\n"
+         << "  --csv ARQ              Arquivo com as medicoes por fase (padrao escala.csv)\n"
+         << "  --semente N            Semente do gerador (padrao 1)\n"
+         << "  --capacidade N         Capacidade do veiculo (padrao 200)\n"
+         << "  --nos-requeridos F     Fracao de nos com demanda (padrao 0.05)\n"
+         << "  --arestas-requeridas F Fracao de arestas com demanda (padrao 0.3)\n"
+         << "  --arcos-requeridos F   Fracao de arcos com demanda (padrao 0.3)\n"
+         << "  --mao-unica F          Fracao de ruas horizontais de mao unica (padrao 0.3)\n"
+         << "  --memoria-max MB       Maior matriz de distancias alocada; fases acima disso sao puladas (padrao 4096)\n"
+         << "  --max-nos-fw N         Maior numero de nos em que o Floyd-Warshall e executado (padrao 10000)\n"
+         << "  --threads N            Threads do Floyd-Warshall paralelo (0 = numero de nucleos)\n"
+         << "  --busca-local          Mede tambem a busca local (primeira melhora) sobre a solucao gulosa\n"
+         << "  --apenas-gerar         Apenas grava as instancias, sem medir as fases\n"
+         << "  --ajuda                Mostra esta mensagem\n";
+}
+
+bool lerOpcoesEscala(int argc, char *argv[], OpcoesEscala &opcoes)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        int inteiro = 0;
+        if (arg == "--ajuda" || arg == "-h")
+        {
+            imprimirUsoEscala(argv[0]);
+            return false;
+        }
+        else if (arg == "--tamanhos" && i + 1 < argc)
+        {
+            opcoes.tamanhos.clear();
+            stringstream lista(argv[++i]);
+            string item;
+            while (getline(lista, item, ','))
+            {
+                int v = atoi(item.c_str());
+                if (v < 2)
+                {
+                    cerr << "Tamanho invalido em --tamanhos: " << item << endl;
+                    return false;
+                }
+                opcoes.tamanhos.push_back(v);
+            }
+        }
+        else if (arg == "--csv" && i + 1 < argc)
+            opcoes.arquivoCsv = argv[++i];
+        else if (arg == "--semente")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, inteiro))
+                return false;
+            opcoes.gerador.semente = static_cast<unsigned long long>(inteiro);
+        }
+        else if (arg == "--capacidade")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.gerador.capacidade))
+                return false;
+        }
+        else if (arg == "--nos-requeridos")
+        {
+            if (!lerArgumentoReal(argc, argv, i, opcoes.gerador.fracaoNosRequeridos))
+                return false;
+        }
+        else if (arg == "--arestas-requeridas")
+        {
+            if (!lerArgumentoReal(argc, argv, i, opcoes.gerador.fracaoArestasRequeridas))
+                return false;
+        }
+        else if (arg == "--arcos-requeridos")
+        {
+            if (!lerArgumentoReal(argc, argv, i, opcoes.gerador.fracaoArcosRequeridos))
+                return false;
+        }
+        else if (arg == "--mao-unica")
+        {
+            if (!lerArgumentoReal(argc, argv, i, opcoes.gerador.fracaoMaoUnica))
+                return false;
+        }
+        else if (arg == "--memoria-max")
+        {
+            if (!lerArgumentoReal(argc, argv, i, opcoes.memoriaMaxMB))
+                return false;
+        }
+        else if (arg == "--max-nos-fw")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.maxNosFW))
+                return false;
+        }
+        else if (arg == "--threads")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.configFW.numThreads))
+                return false;
+        }
+        else if (arg == "--busca-local")
+            opcoes.buscaLocal = true;
+        else if (arg == "--apenas-gerar")
+            opcoes.apenasGerar = true;
+        else if (!arg.empty() && arg[0] != '-')
+            opcoes.pastaSaida = arg;
+        else
+        {
+            cerr << "Opcao desconhecida: " << arg << endl;
+            imprimirUsoEscala(argv[0]);
+            return false;
+        }
+    }
+    if (opcoes.gerador.capacidade < 1)
+    {
+        cerr << "A capacidade deve ser positiva." << endl;
+        return false;
+    }
+    return true;
+}
+
+// Mede uma fase: tempo de parede e pico de memória residente durante a execução.
+MedicaoFase medirFase(const string &fase, const function<void()> &executar)
+{
+    MedicaoFase m;
+    m.fase = fase;
+    reiniciarPicoMemoria();
+    auto inicio = chrono::steady_clock::now();
+    executar();
+    m.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    m.picoMB = picoMemoriaMB();
+    return m;
+}
+
+// Tamanho em MB de uma matriz de distâncias (n+1)x(n+1) com elementos de bytesPorCusto bytes.
+double tamanhoMatrizMB(long long n, int bytesPorCusto)
+{
+    return static_cast<double>(n + 1) * (n + 1) * bytesPorCusto / (1024.0 * 1024.0);
+}
+
+// Executa todas as fases para uma instância de V nós e grava as medições no CSV (ao fim de cada tamanho, para
+// que uma execução interrompida nos tamanhos maiores preserve os anteriores).
+void medirTamanho(int V, const OpcoesEscala &opcoes, ostream &csv)
+{
+    ConfigGerador configGerador = opcoes.gerador;
+    configGerador.numNos = V;
+    const string nome = "sintetica-n" + to_string(V);
+    const string arquivo = (std::filesystem::path(opcoes.pastaSaida) / (nome + ".dat")).string();
+    vector<MedicaoFase> daInstancia;
+
+    bool gravou = false;
+    daInstancia.push_back(medirFase("geracao", [&]()
+                                    { gravou = escreverInstancia(arquivo, gerarInstancia(configGerador, nome)); }));
+    if (!gravou)
+    {
+        cerr << "Erro ao gravar a instancia: " << arquivo << endl;
+        return;
+    }
+    if (!opcoes.apenasGerar)
+    {
+        DadosInstancia dados;
+        daInstancia.push_back(medirFase("leitura", [&]()
+                                        { dados = lerGrafoMapeado(arquivo); }));
+        vector<Servico> servicos = montarListaServicos(dados.g);
+
+        // Floyd-Warshall (matriz completa), se a matriz couber no limite
+        unique_ptr<OraculoDistancias> oraculo;
+        ConfigOraculo configMatriz;
+        configMatriz.modo = ModoOraculo::MATRIZ;
+        const int bytesMatriz = custosCabemEm32Bits(dados.g) ? 4 : 8;
+        if (V > opcoes.maxNosFW)
+        {
+            MedicaoFase pulada;
+            pulada.fase = "floyd_warshall";
+            pulada.observacao = "pulada: mais de " + to_string(opcoes.maxNosFW) + " nos";
+            daInstancia.push_back(pulada);
+        }
+        else if (tamanhoMatrizMB(V, bytesMatriz) <= opcoes.memoriaMaxMB)
+        {
+            daInstancia.push_back(medirFase("floyd_warshall", [&]()
+                                            { oraculo = criarOraculoDistancias(dados.g, configMatriz, opcoes.configFW); }));
+        }
+        else
+        {
+            MedicaoFase pulada;
+            pulada.fase = "floyd_warshall";
+            pulada.observacao = "pulada: matriz de " + to_string(static_cast<long long>(tamanhoMatrizMB(V, bytesMatriz))) + " MB";
+            daInstancia.push_back(pulada);
+        }
+
+        // Nós-chave: da matriz completa ou, sem ela, por Dijkstra sob demanda (uma execução por nó-chave)
+        vector<char> ehChave(V + 1, 0);
+        long long K = 0;
+        auto marcar = [&](int no)
+        { if (no > 0 && no <= V && !ehChave[no]) { ehChave[no] = 1; K++; } };
+        marcar(dados.idNoDeposito);
+        for (const Servico &s : servicos)
+        {
+            marcar(s.tipo == Servico::Tipo::NO ? s.idNoOriginal : s.uOriginal);
+            marcar(s.tipo == Servico::Tipo::NO ? s.idNoOriginal : s.vOriginal);
+        }
+        InstanciaPreparada inst;
+        bool temNosChave = false;
+        if (tamanhoMatrizMB(K, 8) <= opcoes.memoriaMaxMB)
+        {
+            daInstancia.push_back(medirFase("nos_chave", [&]()
+                                            {
+                if (!oraculo)
+                {
+                    ConfigOraculo configDijkstra;
+                    configDijkstra.modo = ModoOraculo::DIJKSTRA;
+                    oraculo = criarOraculoDistancias(dados.g, configDijkstra, opcoes.configFW);
+                }
+                inst.nosChave = construirNosChave(dados, servicos, *oraculo); }));
+            daInstancia.back().observacao = "K=" + to_string(K);
+            temNosChave = true;
+        }
+        else
+        {
+            MedicaoFase pulada;
+            pulada.fase = "nos_chave";
+            pulada.observacao = "pulada: K=" + to_string(K) + ", matriz de " +
+                                to_string(static_cast<long long>(tamanhoMatrizMB(K, 8))) + " MB";
+            daInstancia.push_back(pulada);
+        }
+        oraculo.reset();
+
+        if (temNosChave)
+        {
+            inst.nomeInstancia = nome;
+            inst.idNoDeposito = dados.idNoDeposito;
+            inst.capacidadeVeiculo = dados.capacidadeVeiculo;
+            inst.numNos = V;
+            inst.servicos = servicos;
+            inst.chaveDeposito = inst.nosChave.chaveDeposito;
+            inst.noDaChave = inst.nosChave.noDaChave.data();
+            inst.distChaves = inst.nosChave.dist.visao();
+
+            Solucao solucao;
+            ostringstream mensagens;
+            daInstancia.push_back(medirFase("construtivo", [&]()
+                                            { solucao = construirSolucaoGulosa(inst, TAMANHO_LISTA_CANDIDATOS, mensagens, mensagens); }));
+            daInstancia.back().observacao = "custo=" + to_string(solucao.custoTotal) + " rotas=" + to_string(solucao.rotas.size());
+
+            if (opcoes.buscaLocal)
+            {
+                ConfigBuscaLocal configBL;
+                daInstancia.push_back(medirFase("busca_local", [&]()
+                                                {
+                    BuscaLocal buscaLocal(inst.servicos, inst.distChaves, inst.chaveDeposito, inst.capacidadeVeiculo, configBL);
+                    buscaLocal.otimizar(solucao); }));
+                daInstancia.back().observacao = "custo=" + to_string(solucao.custoTotal);
+            }
+        }
+    }
+
+    int numServicos = 0, arestas = 0, arcos = 0;
+    {
+        CabecalhoInstancia cab = lerCabecalhoInstancia(arquivo);
+        numServicos = cab.numServicos();
+        arestas = cab.numArestas;
+        arcos = cab.numArcos;
+    }
+    for (MedicaoFase &m : daInstancia)
+    {
+        m.nos = V;
+        m.arestas = arestas;
+        m.arcos = arcos;
+        m.servicos = numServicos;
+        cout << nome << "\t" << m.fase << "\t" << m.segundos << " s\t" << m.picoMB << " MB"
+             << (m.observacao.empty() ? "" : "\t" + m.observacao) << endl;
+        csv << m.nos << "," << m.arestas << "," << m.arcos << "," << m.servicos << "," << m.fase << ","
+            << m.segundos << "," << m.picoMB << "," << m.observacao << "\n";
+    }
+    csv << flush;
+}
+
+int main(int argc, char *argv[])
+{
+    OpcoesEscala opcoes;
+    if (!lerOpcoesEscala(argc, argv, opcoes))
+        return 1;
+    error_code ec;
+    std::filesystem::create_directories(opcoes.pastaSaida, ec);
+    if (ec)
+    {
+        cerr << "Erro ao criar a pasta de saida: " << opcoes.pastaSaida << " - " << ec.message() << endl;
+        return 1;
+    }
+
+    ofstream csv(opcoes.arquivoCsv);
+    if (!csv)
+    {
+        cerr << "Erro ao criar o arquivo: " << opcoes.arquivoCsv << endl;
+        return 1;
+    }
+    csv << "nos,arestas,arcos,servicos,fase,segundos,pico_memoria_mb,observacao\n";
+    for (int V : opcoes.tamanhos)
+        medirTamanho(V, opcoes, csv);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#ifndef ESCRITA_RAPIDA_HPP
+#define ESCRITA_RAPIDA_HPP
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <type_traits>
+#include <cerrno>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Buffer de saída para arquivos gerados pelo programa (soluções, rotas expandidas). O conteúdo é formatado
+// em memória com to_chars, sem fluxos nem strings temporárias, e o arquivo é gravado de uma vez com uma única
+// chamada de escrita. O mesmo buffer pode ser reaproveitado de um arquivo para o próximo (limpar mantém a
+// capacidade), então a escrita em lote não aloca memória depois dos primeiros arquivos.
+class BufferSaida
+{
+public:
+    void limpar() { dados.clear(); }
+
+    void texto(string_view s) { dados.append(s.data(), s.size()); }
+    void caractere(char c) { dados.push_back(c); }
+
+    template <typename Inteiro>
+    void inteiro(Inteiro valor)
+    {
+        char digitos[24];
+        dados.append(digitos, to_chars(digitos, digitos + sizeof(digitos), valor).ptr);
+    }
+
+    // Bytes de um valor na representação da memória (formatos binários).
+    template <typename T>
+    void binario(const T &valor)
+    {
+        static_assert(is_trivially_copyable<T>::value, "Apenas tipos copiáveis byte a byte");
+        dados.append(reinterpret_cast<const char *>(&valor), sizeof(T));
+    }
+
+    string_view conteudo() const { return dados; }
+    size_t tamanho() const { return dados.size(); }
+
+    // Grava o conteúdo em nomeArquivo (substituindo o arquivo). Retorna false se não conseguir abrir ou gravar.
+    bool gravar(const string &nomeArquivo) const
+    {
+#ifdef _WIN32
+        HANDLE h = CreateFileA(nomeArquivo.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                               nullptr);
+        if (h == INVALID_HANDLE_VALUE)
+            return false;
+        const char *p = dados.data();
+        size_t restante = dados.size();
+        bool ok = true;
+        while (ok && restante > 0)
+        {
+            DWORD escritos = 0;
+            DWORD pedaco = static_cast<DWORD>(restante < (1u << 30) ? restante : (1u << 30));
+            ok = WriteFile(h, p, pedaco, &escritos, nullptr) && escritos > 0;
+            p += escritos;
+            restante -= escritos;
+        }
+        return CloseHandle(h) && ok;
+#else
+        int descritor = open(nomeArquivo.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (descritor < 0)
+            return false;
+        // Normalmente uma única chamada; o laço cobre escritas parciais
+        const char *p = dados.data();
+        size_t restante = dados.size();
+        bool ok = true;
+        while (ok && restante > 0)
+        {
+            ssize_t escritos = write(descritor, p, restante);
+            if (escritos < 0 && errno == EINTR)
+                continue;
+            ok = escritos > 0;
+            if (ok)
+            {
+                p += escritos;
+                restante -= static_cast<size_t>(escritos);
+            }
+        }
+        return close(descritor) == 0 && ok;
+#endif
+    }
+
+private:
+    string dados;
+};
+
+#endif // ESCRITA_RAPIDA_HPP
@@ -0,0 +1,120 @@
+#ifndef EXPANSAO_ROTAS_HPP
+#define EXPANSAO_ROTAS_HPP
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "grafo.hpp"              // Grafo, Servico
+#include "oraculo_distancias.hpp" // dijkstraUmaOrigem
+#include "solucao.hpp"            // Solucao, Rota, Visita, chaveEntrada/chaveSaida
+#include "escrita_rapida.hpp"     // BufferSaida
+
+using namespace std;
+
+// Expansão das rotas em sequências completas de nós do grafo, para despacho dos veículos. O arquivo de
+// solução lista apenas os serviços; os deslocamentos entre eles são caminhos mínimos que a heurística
+// conhece só pelo custo (matriz entre nós-chave). Como todo deslocamento parte de um nó-chave (depósito ou
+// extremidade de serviço), basta a árvore de caminhos mínimos de cada nó-chave de origem: um vetor de
+// predecessores com a largura dos IDs de nó, calculado por Dijkstra na primeira vez em que a origem é usada.
+// Nada é calculado se nenhuma rota for expandida, e nunca há um segundo cálculo entre todos os pares.
+class ExpansorRotas
+{
+public:
+    ExpansorRotas(const Grafo &g_, const int *noDaChave_, int numChaves)
+        : g(g_), noDaChave(noDaChave_), arvores(numChaves + 1), distTemp(g_.V + 1) {}
+
+    // Acrescenta a nos o caminho mínimo do nó-chave origem ao nó-chave destino, sem o nó de origem (que já
+    // é o último de nos). Retorna false se o destino for inalcançável.
+    bool anexarCaminho(int chaveOrigem, int chaveDestino, vector<int> &nos)
+    {
+        const int origem = noDaChave[chaveOrigem], destino = noDaChave[chaveDestino];
+        if (origem == destino)
+            return true;
+        const vector<int> &predecessor = arvore(chaveOrigem);
+        const size_t inicio = nos.size();
+        for (int v = destino; v != origem; v = predecessor[v])
+        {
+            if (predecessor[v] == 0)
+            {
+                nos.resize(inicio);
+                return false;
+            }
+            nos.push_back(v);
+        }
+        reverse(nos.begin() + inicio, nos.end());
+        return true;
+    }
+
+    // Sequência de nós percorrida pela rota: depósito, deslocamentos, travessia de cada serviço e volta ao
+    // depósito. Serviços em nó aparecem uma vez; arestas e arcos, pelas duas extremidades no sentido usado.
+    // Retorna false se algum deslocamento for impossível (a sequência fica incompleta nesse trecho).
+    bool expandirRota(const Rota &rota, const vector<Servico> &servicos, int chaveDeposito, vector<int> &nos)
+    {
+        nos.assign(1, noDaChave[chaveDeposito]);
+        bool completa = true;
+        int chaveAtual = chaveDeposito;
+        for (const Visita &v : rota.visitas)
+        {
+            const Servico &s = servicos[v.servico];
+            completa = anexarCaminho(chaveAtual, chaveEntrada(s, v.invertido), nos) && completa;
+            if (s.tipo != Servico::Tipo::NO)
+                nos.push_back(noDaChave[chaveSaida(s, v.invertido)]);
+            chaveAtual = chaveSaida(s, v.invertido);
+        }
+        return anexarCaminho(chaveAtual, chaveDeposito, nos) && completa;
+    }
+
+    int arvoresCalculadas() const { return numArvores; }
+
+private:
+    // Árvore de caminhos mínimos a partir do nó-chave (calculada sob demanda).
+    const vector<int> &arvore(int chave)
+    {
+        vector<int> &predecessor = arvores[chave];
+        if (predecessor.empty())
+        {
+            predecessor.resize(g.V + 1);
+            dijkstraUmaOrigem(g, noDaChave[chave], distTemp.data(), predecessor.data());
+            numArvores++;
+        }
+        return predecessor;
+    }
+
+    const Grafo &g;
+    const int *noDaChave;
+    vector<vector<int>> arvores; // Predecessores por nó-chave de origem (vazio = ainda não calculada)
+    vector<long long> distTemp;  // Distâncias do último Dijkstra (só a árvore é guardada)
+    int numArvores = 0;
+};
+
+// Grava as rotas expandidas: uma linha por rota não vazia, "id num_nos n1 n2 ... nk", na mesma numeração
+// do arquivo de solução. Rotas com deslocamento impossível são marcadas com "incompleta" no fim da linha.
+// O arquivo é montado em buffer e gravado de uma vez. Retorna false se não conseguir gravar.
+bool escreverRotasExpandidas(const string &nomeArquivo, const Solucao &solucao, const vector<Servico> &servicos,
+                             int chaveDeposito, ExpansorRotas &expansor, BufferSaida &buffer)
+{
+    buffer.limpar();
+    vector<int> nos;
+    int idRota = 1;
+    for (const Rota &r : solucao.rotas)
+    {
+        if (r.visitas.empty())
+            continue;
+        bool completa = expansor.expandirRota(r, servicos, chaveDeposito, nos);
+        buffer.inteiro(idRota++);
+        buffer.caractere(' ');
+        buffer.inteiro(nos.size());
+        for (int no : nos)
+        {
+            buffer.caractere(' ');
+            buffer.inteiro(no);
+        }
+        if (!completa)
+            buffer.texto(" incompleta");
+        buffer.caractere('\n');
+    }
+    return buffer.gravar(nomeArquivo);
+}
+
+#endif // EXPANSAO_ROTAS_HPP
@@ -0,0 +1,326 @@
+#ifndef FONTE_INSTANCIAS_HPP
+#define FONTE_INSTANCIAS_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+
+#include "grafo.hpp"          // DadosInstancia, CabecalhoInstancia
+#include "leitura_rapida.hpp" // ArquivoMapeado, lerInstanciaDeMemoria
+#include "descompactacao.hpp" // descompactarDeflate, calcularCrc32
+
+using namespace std;
+
+// Conteúdo bruto (texto) de uma instância: uma visão sobre o arquivo mapeado ou sobre um buffer descompactado.
+struct ConteudoInstancia
+{
+    unique_ptr<ArquivoMapeado> mapa; // Mantém o arquivo mapeado enquanto texto for usado
+    vector<char> buffer;             // Dados descompactados (membros de .zip)
+    string_view texto;
+};
+
+// Origem dos arquivos de instância .dat: uma pasta no disco ou um arquivo .zip.
+// As implementações devem permitir chamadas concorrentes de ler()/lerCabecalho() (modo em lote).
+class FonteInstancias
+{
+public:
+    virtual ~FonteInstancias() = default;
+
+    // Número de instâncias disponíveis (ordenadas pelo nome).
+    virtual int quantidade() const = 0;
+
+    // Identificação da instância i para mensagens (caminho do arquivo ou "arquivo.zip:membro").
+    virtual const string &descricao(int i) const = 0;
+
+    // Faz o parsing completo da instância i em dados (reaproveitando a memória já alocada nos seus vetores).
+    // Em caso de erro, dados fica com idNoDeposito = -1 e o motivo é escrito em erros (o fluxo da instância,
+    // para que as mensagens do lote saiam na ordem dos arquivos).
+    virtual void ler(int i, DadosInstancia &dados, EstatisticasLeitura *estatisticas, ostream &erros) const = 0;
+
+    // Lê apenas as contagens do cabeçalho da instância i (para estimar seu tamanho).
+    virtual CabecalhoInstancia lerCabecalho(int i) const = 0;
+
+    // Obtém o texto bruto da instância i sem fazer o parsing. Retorna false (após escrever o erro) se falhar.
+    virtual bool obterConteudo(int i, ConteudoInstancia &conteudo, ostream &erros) const = 0;
+
+    // Nome base da instância i (ex.: "BHW1").
+    virtual string nomeInstancia(int i) const { return extrairNomeBaseInstancia(descricao(i)); }
+};
+
+// Instâncias em uma pasta do disco: cada arquivo .dat é lido com lerGrafoMapeado ou lerGrafoDeArquivo.
+class FontePasta : public FonteInstancias
+{
+public:
+    FontePasta(vector<string> arquivos_, bool leituraMapeada_)
+        : arquivos(std::move(arquivos_)), leituraMapeada(leituraMapeada_) {}
+
+    int quantidade() const override { return static_cast<int>(arquivos.size()); }
+    const string &descricao(int i) const override { return arquivos[i]; }
+
+    void ler(int i, DadosInstancia &dados, EstatisticasLeitura *estatisticas, ostream &erros) const override
+    {
+        if (leituraMapeada)
+            lerGrafoMapeado(arquivos[i], dados, estatisticas, erros);
+        else
+            dados = lerGrafoDeArquivo(arquivos[i], erros);
+    }
+
+    CabecalhoInstancia lerCabecalho(int i) const override { return lerCabecalhoInstancia(arquivos[i]); }
+
+    bool obterConteudo(int i, ConteudoInstancia &conteudo, ostream &erros) const override
+    {
+        conteudo.mapa = make_unique<ArquivoMapeado>(arquivos[i]);
+        if (!conteudo.mapa->estaAberto())
+        {
+            erros << "Erro ao abrir o arquivo: " << arquivos[i] << endl;
+            return false;
+        }
+        conteudo.texto = string_view(conteudo.mapa->dados(), conteudo.mapa->tamanho());
+        return true;
+    }
+
+private:
+    vector<string> arquivos;
+    bool leituraMapeada;
+};
+
+// Instâncias dentro de um arquivo .zip. O arquivo inteiro é mapeado em memória uma única vez e cada
+// membro .dat é descompactado diretamente para um buffer em memória e entregue ao parser, sem
+// arquivos temporários. Suporta membros armazenados (método 0) e DEFLATE (método 8); não suporta ZIP64.
+class FonteZip : public FonteInstancias
+{
+public:
+    FonteZip(const string &caminhoZip_) : caminhoZip(caminhoZip_), arquivo(caminhoZip_)
+    {
+        if (!arquivo.estaAberto())
+        {
+            erro = "nao foi possivel abrir o arquivo";
+            return;
+        }
+        lerDiretorioCentral();
+    }
+
+    bool valida() const { return erro.empty(); }
+    const string &mensagemErro() const { return erro; }
+
+    int quantidade() const override { return static_cast<int>(membros.size()); }
+    const string &descricao(int i) const override { return membros[i].descricao; }
+    // Pelo nome do membro: para um membro na raiz do .zip, a descrição daria "arquivo.zip:membro"
+    string nomeInstancia(int i) const override { return extrairNomeBaseInstancia(membros[i].nome); }
+
+    void ler(int i, DadosInstancia &dados, EstatisticasLeitura *estatisticas, ostream &erros) const override
+    {
+        auto inicio = chrono::steady_clock::now();
+        thread_local vector<char> buffer; // Reaproveitado entre as instâncias lidas pela mesma thread
+        string_view texto;
+        const Membro &m = membros[i];
+        if (!obterConteudo(m, buffer, texto, erros))
+        {
+            dados.g.inicializarGrafoInterno(0);
+            dados.idNoDeposito = -1;
+            dados.capacidadeVeiculo = 0;
+            dados.nomeInstancia = extrairNomeBaseInstancia(m.nome);
+            return;
+        }
+        lerInstanciaDeMemoria(texto, extrairNomeBaseInstancia(m.nome), dados);
+        if (estatisticas)
+        {
+            estatisticas->bytes = texto.size();
+            estatisticas->segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        }
+    }
+
+    CabecalhoInstancia lerCabecalho(int i) const override
+    {
+        vector<char> buffer;
+        string_view texto;
+        ostringstream descartadas; // O erro é informado quando a instância for lida
+        if (!obterConteudo(membros[i], buffer, texto, descartadas))
+            return CabecalhoInstancia();
+        return lerCabecalhoDeMemoria(texto);
+    }
+
+    bool obterConteudo(int i, ConteudoInstancia &conteudo, ostream &erros) const override
+    {
+        return obterConteudo(membros[i], conteudo.buffer, conteudo.texto, erros);
+    }
+
+private:
+    struct Membro
+    {
+        string nome;              // Nome do membro dentro do .zip
+        string descricao;         // "caminho.zip:nome"
+        uint16_t metodo;          // 0 = armazenado, 8 = DEFLATE
+        uint32_t crc;             // CRC-32 do conteúdo descompactado
+        uint32_t tamCompactado;   // Tamanho dos dados no .zip
+        uint32_t tamOriginal;     // Tamanho descompactado
+        uint32_t offsetCabecalho; // Posição do cabeçalho local do membro
+    };
+
+    static uint16_t ler16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+    static uint32_t ler32(const uint8_t *p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    // Localiza o registro de fim do diretório central e lista os membros .dat.
+    void lerDiretorioCentral()
+    {
+        const uint8_t *base = reinterpret_cast<const uint8_t *>(arquivo.dados());
+        const size_t tam = arquivo.tamanho();
+        const uint32_t ASSINATURA_FIM = 0x06054b50, ASSINATURA_CENTRAL = 0x02014b50;
+
+        // O registro de fim tem 22 bytes mais um comentário opcional de até 65535 bytes
+        size_t posFim = string::npos;
+        if (tam >= 22)
+        {
+            size_t limite = tam - 22 > 65535 ? tam - 22 - 65535 : 0;
+            for (size_t p = tam - 22 + 1; p-- > limite;)
+            {
+                if (ler32(base + p) == ASSINATURA_FIM)
+                {
+                    posFim = p;
+                    break;
+                }
+            }
+        }
+        if (posFim == string::npos)
+        {
+            erro = "registro de fim do diretorio central nao encontrado";
+            return;
+        }
+
+        uint16_t numEntradas = ler16(base + posFim + 10);
+        size_t pos = ler32(base + posFim + 16);
+        for (int e = 0; e < numEntradas; ++e)
+        {
+            if (pos + 46 > tam || ler32(base + pos) != ASSINATURA_CENTRAL)
+            {
+                erro = "diretorio central corrompido";
+                return;
+            }
+            Membro m;
+            m.metodo = ler16(base + pos + 10);
+            m.crc = ler32(base + pos + 16);
+            m.tamCompactado = ler32(base + pos + 20);
+            m.tamOriginal = ler32(base + pos + 24);
+            uint16_t tamNome = ler16(base + pos + 28), tamExtra = ler16(base + pos + 30), tamComentario = ler16(base + pos + 32);
+            m.offsetCabecalho = ler32(base + pos + 42);
+            if (pos + 46 + tamNome + tamExtra + tamComentario > tam)
+            {
+                erro = "diretorio central corrompido";
+                return;
+            }
+            m.nome.assign(reinterpret_cast<const char *>(base + pos + 46), tamNome);
+            pos += 46 + tamNome + tamExtra + tamComentario;
+
+            if (m.nome.size() >= 4 && m.nome.compare(m.nome.size() - 4, 4, ".dat") == 0)
+            {
+                m.descricao = caminhoZip + ":" + m.nome;
+                membros.push_back(std::move(m));
+            }
+        }
+        sort(membros.begin(), membros.end(), [](const Membro &a, const Membro &b)
+             { return a.nome < b.nome; });
+    }
+
+    // Obtém o texto de um membro: uma visão direta do .zip (armazenado) ou o buffer descompactado.
+    bool obterConteudo(const Membro &m, vector<char> &buffer, string_view &texto, ostream &erros) const
+    {
+        const uint8_t *base = reinterpret_cast<const uint8_t *>(arquivo.dados());
+        const size_t tam = arquivo.tamanho();
+        size_t pos = m.offsetCabecalho;
+        if (pos + 30 > tam || ler32(base + pos) != 0x04034b50)
+        {
+            erros << "Erro no membro " << m.descricao << ": cabecalho local invalido" << endl;
+            return false;
+        }
+        pos += 30 + ler16(base + pos + 26) + ler16(base + pos + 28); // Pula nome e campo extra locais
+        if (pos + m.tamCompactado > tam)
+        {
+            erros << "Erro no membro " << m.descricao << ": dados truncados" << endl;
+            return false;
+        }
+
+        if (m.metodo == 0)
+        {
+            texto = string_view(reinterpret_cast<const char *>(base + pos), m.tamCompactado);
+        }
+        else if (m.metodo == 8)
+        {
+            string mensagem;
+            if (!descompactarDeflate(base + pos, m.tamCompactado, m.tamOriginal, buffer, mensagem))
+            {
+                erros << "Erro ao descompactar " << m.descricao << ": " << mensagem << endl;
+                return false;
+            }
+            texto = string_view(buffer.data(), buffer.size());
+        }
+        else
+        {
+            erros << "Erro no membro " << m.descricao << ": metodo de compressao " << m.metodo << " nao suportado" << endl;
+            return false;
+        }
+
+        if (calcularCrc32(texto.data(), texto.size()) != m.crc)
+        {
+            erros << "Erro no membro " << m.descricao << ": CRC-32 nao confere" << endl;
+            return false;
+        }
+        return true;
+    }
+
+    string caminhoZip;
+    ArquivoMapeado arquivo;
+    vector<Membro> membros;
+    string erro;
+};
+
+// Abre a fonte de instâncias: um arquivo .zip ou uma pasta com arquivos .dat (ordenados pelo nome).
+// Retorna nullptr (após escrever o erro) se a origem não puder ser lida.
+unique_ptr<FonteInstancias> abrirFonteInstancias(const string &caminho, bool leituraMapeada, ostream &erros)
+{
+    namespace fs = std::filesystem;
+    if (fs::path(caminho).extension() == ".zip")
+    {
+        auto fonte = make_unique<FonteZip>(caminho);
+        if (!fonte->valida())
+        {
+            erros << "Erro ao abrir o arquivo zip de instancias: " << caminho << " - " << fonte->mensagemErro() << endl;
+            return nullptr;
+        }
+        return fonte;
+    }
+
+    vector<string> arquivosDat; // Para armazenar os caminhos dos arquivos .dat encontrados
+    try
+    {
+        // Itera sobre os arquivos na pasta de instâncias
+        for (const auto &entry : fs::directory_iterator(caminho))
+        {
+            // Adiciona à lista se for um arquivo regular com extensão .dat
+            if (entry.is_regular_file() && entry.path().extension() == ".dat")
+            {
+                arquivosDat.push_back(entry.path().string());
+            }
+        }
+    }
+    catch (const fs::filesystem_error &e)
+    {
+        erros << "Erro ao acessar a pasta de instancias: " << caminho << " - " << e.what() << endl;
+        return nullptr;
+    }
+
+    sort(arquivosDat.begin(), arquivosDat.end()); // Ordenamento dos arquivos (é opcional para consistência do código)
+    return make_unique<FontePasta>(std::move(arquivosDat), leituraMapeada);
+}
+
+#endif // FONTE_INSTANCIAS_HPP
@@ -9,13 +9,13 @@
 #include <algorithm>
 #include <limits>
 
-#include "grafo.hpp" // Contém as definições de Grafo e seus componentes
+#include "grafo.hpp"             // Contém as definições de Grafo e seus componentes
+#include "matriz_distancias.hpp" // Matriz de distâncias contígua e núcleo blocado do Floyd-Warshall
+#include "intermediacao.hpp"     // Intermediação pelo algoritmo de Brandes
+#include "metricas.hpp"          // Métricas de distância em uma passada sobre a matriz
 
 using namespace std;
 
-// Define um valor grande para representar "infinito" em distâncias do tipo long long.
-const long long LONGLONG_INF = numeric_limits<long long>::max();
-
 // Calcula o número de vértices que possuem demanda positiva (serviços em nós).
 int calcularVerticesRequeridos(const Grafo &g)
 {
@@ -71,15 +71,15 @@ double calcularDensidade(const Grafo &g)
 }
 
 // Calcula o grau de um vértice específico (número de arestas incidentes).
-// Utiliza a lista de adjacência de arestas (g.adjArestas).
+// Utiliza a adjacência CSR (entradas de arestas de g.adjacencia).
 int calcularGrau(const Grafo &g, int v_idx)
 {
     // Validação do índice do vértice
-    if (v_idx <= 0 || v_idx > g.V || static_cast<size_t>(v_idx) >= g.adjArestas.size())
+    if (v_idx <= 0 || v_idx > g.V || static_cast<size_t>(v_idx) >= g.adjacencia.fimArestas.size())
     {
         return 0;
     }
-    return g.adjArestas[v_idx].size();
+    return g.adjacencia.grauArestas(v_idx);
 }
 
 // Calcula o grau mínimo entre todos os vértices do grafo.
@@ -92,7 +92,7 @@ int calcularGrauMinimo(const Grafo &g)
     for (int i = 1; i <= g.V; i++)
     {
         // Garante que o índice do vértice é válido para a lista de adjacência
-        if (static_cast<size_t>(i) < g.adjArestas.size())
+        if (static_cast<size_t>(i) < g.adjacencia.fimArestas.size())
         {
             grauMin = min(grauMin, calcularGrau(g, i));
             algumGrauValido = true;
@@ -109,7 +109,7 @@ int calcularGrauMaximo(const Grafo &g)
     int grauMax = 0;
     for (int i = 1; i <= g.V; i++)
     {
-        if (static_cast<size_t>(i) < g.adjArestas.size())
+        if (static_cast<size_t>(i) < g.adjacencia.fimArestas.size())
         {
             grauMax = max(grauMax, calcularGrau(g, i));
         }
@@ -117,18 +117,43 @@ int calcularGrauMaximo(const Grafo &g)
     return grauMax;
 }
 
+// Indica se todas as distâncias mínimas do grafo cabem com folga em uma matriz de 32 bits: os custos são
+// não negativos e a soma de todos eles (limite para qualquer caminho mínimo) fica abaixo do sentinela
+// DIST_INF_SATURADO_32. A soma é feita em 64 bits, então não há overflow na verificação.
+bool custosCabemEm32Bits(const Grafo &g)
+{
+    long long soma = 0;
+    for (const auto &a : g.arestas)
+    {
+        if (a.custo < 0)
+            return false;
+        soma += a.custo;
+    }
+    for (const auto &a : g.arcos)
+    {
+        if (a.custo < 0)
+            return false;
+        soma += a.custo;
+    }
+    return soma < DIST_INF_SATURADO_32;
+}
+
 // Implementa o algoritmo de Floyd-Warshall para encontrar os caminhos mínimos entre todos os pares de nós.
 // Considera um grafo misto (com arestas e arcos).
-// Retorna uma matriz de distâncias onde dist[i][j] é o custo do caminho mínimo de i a j.
-vector<vector<long long>> floydWarshall(const Grafo &g)
+// Retorna uma matriz de distâncias onde dist(i, j) é o custo do caminho mínimo de i a j, armazenada com o
+// tipo Custo (int32_t só deve ser usado quando custosCabemEm32Bits(g) for verdadeiro).
+// Grafos com pelo menos config.limiarParalelo nós usam o núcleo paralelo com config.numThreads threads.
+// Esta versão escreve em uma matriz já existente, reaproveitando seu buffer quando ele comporta o grafo.
+template <typename Custo>
+void floydWarshallT(const Grafo &g, const ConfigFloydWarshall &config, MatrizDistanciasT<Custo> &dist)
 {
     int n = g.V;
-    vector<vector<long long>> dist(n + 1, vector<long long>(n + 1, LONGLONG_INF));
+    dist.redimensionar(n);
 
     // Distância de um nó para ele mesmo é 0
     for (int i = 1; i <= n; i++)
     {
-        dist[i][i] = 0;
+        dist.bruto(i, i) = 0;
     }
 
     // Inicializa distâncias com base nos custos diretos das ARESTAS
@@ -137,8 +162,8 @@ vector<vector<long long>> floydWarshall(const Grafo &g)
         if (aresta.origem > 0 && aresta.origem <= n && aresta.destino > 0 && aresta.destino <= n)
         {
             // Considera o menor custo se houver múltiplas arestas entre os mesmos nós
-            dist[aresta.origem][aresta.destino] = min(dist[aresta.origem][aresta.destino], static_cast<long long>(aresta.custo));
-            dist[aresta.destino][aresta.origem] = min(dist[aresta.destino][aresta.origem], static_cast<long long>(aresta.custo)); // Bidirecional
+            dist.bruto(aresta.origem, aresta.destino) = min(dist.bruto(aresta.origem, aresta.destino), static_cast<Custo>(aresta.custo));
+            dist.bruto(aresta.destino, aresta.origem) = min(dist.bruto(aresta.destino, aresta.origem), static_cast<Custo>(aresta.custo)); // Bidirecional
         }
     }
 
@@ -147,35 +172,40 @@ vector<vector<long long>> floydWarshall(const Grafo &g)
     {
         if (arco.origem > 0 && arco.origem <= n && arco.destino > 0 && arco.destino <= n)
         {
-            dist[arco.origem][arco.destino] = min(dist[arco.origem][arco.destino], static_cast<long long>(arco.custo)); // Direcional
+            dist.bruto(arco.origem, arco.destino) = min(dist.bruto(arco.origem, arco.destino), static_cast<Custo>(arco.custo)); // Direcional
         }
     }
 
-    // Etapa principal do algoritmo de Floyd-Warshall (iterações sobre nós intermediários k)
-    for (int k = 1; k <= n; k++)
+    // Etapa principal do algoritmo (núcleo blocado e sem desvios, ver matriz_distancias.hpp)
+    int numThreads = resolverNumThreads(config.numThreads);
+    if (numThreads > 1 && n >= config.limiarParalelo)
     {
-        for (int i = 1; i <= n; i++)
-        {
-            for (int j = 1; j <= n; j++)
-            {
-                // Se caminhos i->k e k->j existem
-                if (dist[i][k] != LONGLONG_INF && dist[k][j] != LONGLONG_INF)
-                {
-                    // Se o caminho via k é mais curto
-                    if (dist[i][j] > dist[i][k] + dist[k][j])
-                    {
-                        dist[i][j] = dist[i][k] + dist[k][j];
-                    }
-                }
-            }
-        }
+        PoolThreads pool(numThreads);
+        floydWarshallBlocadoParalelo(dist, pool, config.tamanhoBloco);
+    }
+    else
+    {
+        floydWarshallBlocado(dist, config.tamanhoBloco);
     }
+}
+
+template <typename Custo>
+MatrizDistanciasT<Custo> floydWarshallT(const Grafo &g, const ConfigFloydWarshall &config = ConfigFloydWarshall())
+{
+    MatrizDistanciasT<Custo> dist;
+    floydWarshallT(g, config, dist);
     return dist;
 }
 
+// Floyd-Warshall com a matriz de 64 bits (usado pela Etapa 1 e sempre que os custos não cabem em 32 bits).
+MatrizDistancias floydWarshall(const Grafo &g, const ConfigFloydWarshall &config = ConfigFloydWarshall())
+{
+    return floydWarshallT<long long>(g, config);
+}
+
 // Calcula o diâmetro do grafo: o maior dos menores caminhos entre quaisquer dois nós distintos.
 // Retorna LONGLONG_INF se o grafo não for fortemente conectado (algum par não alcançável).
-long long calcularDiametro(const Grafo &g, const vector<vector<long long>> &dist)
+long long calcularDiametro(const Grafo &g, const MatrizDistancias &dist)
 {
     if (g.V < 2)
         return 0; // Diâmetro é 0 para grafos com 0 ou 1 nó
@@ -190,15 +220,15 @@ long long calcularDiametro(const Grafo &g, const vector<vector<long long>> &dist
             if (i == j)
                 continue; // Considera apenas pares distintos
 
-            if (dist[i][j] == LONGLONG_INF)
+            if (dist(i, j) == LONGLONG_INF)
             {
                 algum_caminho_infinito = true; // Indica que o grafo não é fortemente conectado
             }
             else
             {
-                if (dist[i][j] > max_dist_finita)
+                if (dist(i, j) > max_dist_finita)
                 {
-                    max_dist_finita = dist[i][j];
+                    max_dist_finita = dist(i, j);
                 }
             }
         }
@@ -209,46 +239,16 @@ long long calcularDiametro(const Grafo &g, const vector<vector<long long>> &dist
 
 // Calcula uma métrica de "intermediação média":
 // (Soma de nós intermediários em caminhos mais curtos s-v-t) / (Número de pares (s,t) com caminho finito).
-float calcularIntermediacao(const Grafo &g, const vector<vector<long long>> &dist)
+// Usa o motor de Brandes (intermediacao.hpp), com uma passada por origem em paralelo, em vez de
+// verificar todas as triplas (s, v, t) na matriz de distâncias.
+float calcularIntermediacao(const Grafo &g, int numThreads = 0)
 {
-    if (g.V < 3)
-        return 0.0f; // Intermediação não é significativa para menos de 3 nós
-    int n = g.V;
-    double soma_nos_intermediarios_em_caminhos_st = 0.0;
-    int num_pares_st_com_caminho_finito = 0;
-
-    for (int s = 1; s <= n; ++s)
-    {
-        for (int t = 1; t <= n; ++t)
-        {
-            if (s == t)
-                continue; // Pares (s,t) distintos
-            if (dist[s][t] != LONGLONG_INF)
-            { // Se existe caminho finito entre s e t
-                num_pares_st_com_caminho_finito++;
-                // Verifica cada nó v_intermed como possível intermediário
-                for (int v_intermed = 1; v_intermed <= n; ++v_intermed)
-                {
-                    if (v_intermed == s || v_intermed == t)
-                        continue; // Intermediário deve ser diferente de s e t
-                    // Se v_intermed está em um caminho mais curto entre s e t
-                    if (dist[s][v_intermed] != LONGLONG_INF && dist[v_intermed][t] != LONGLONG_INF &&
-                        dist[s][t] == (dist[s][v_intermed] + dist[v_intermed][t]))
-                    {
-                        soma_nos_intermediarios_em_caminhos_st += 1.0;
-                    }
-                }
-            }
-        }
-    }
-    if (num_pares_st_com_caminho_finito == 0)
-        return 0.0f; // Evita divisão por zero
-    return static_cast<float>(soma_nos_intermediarios_em_caminhos_st / num_pares_st_com_caminho_finito);
+    return static_cast<float>(calcularIntermediacaoBrandes(g, numThreads).media());
 }
 
 // Calcula o caminho médio do grafo: a média das distâncias mínimas
 // entre todos os pares de nós distintos que são alcançáveis.
-double calcularCaminhoMedio(const Grafo &g, const vector<vector<long long>> &dist)
+double calcularCaminhoMedio(const Grafo &g, const MatrizDistancias &dist)
 {
     if (g.V < 2)
         return 0.0; // Não definido para menos de 2 nós
@@ -260,9 +260,9 @@ double calcularCaminhoMedio(const Grafo &g, const vector<vector<long long>> &dis
     {
         for (int j = i + 1; j <= n; ++j)
         { // Considera cada par (i,j) uma vez
-            if (dist[i][j] != LONGLONG_INF)
+            if (dist(i, j) != LONGLONG_INF)
             {
-                soma_distancias_finitas += static_cast<double>(dist[i][j]);
+                soma_distancias_finitas += static_cast<double>(dist(i, j));
                 num_pares_alcancaveis++;
             }
         }
@@ -299,35 +299,12 @@ void imprimirGrafo(ofstream &outputFile, const Grafo &g)
 }
 
 // Calcula um conjunto de métricas do grafo e as imprime em uma linha de um arquivo CSV.
-// Usada principalmente para a Etapa 1 do projeto.
+// Usada principalmente para a Etapa 1 do projeto. As métricas de distância saem de uma única passada
+// pela matriz do Floyd-Warshall (metricas.hpp).
 void imprimirMetricas(ofstream &outputFileCSV, const string &nomeGrafoNoArquivo, const Grafo &g)
 {
-    // Cálcula métricas básicas
-    int verticesReq = calcularVerticesRequeridos(g);
-    int arestasReq = calcularArestasRequeridas(g);
-    int arcosReq = calcularArcosRequeridos(g);
-    double dens = calcularDensidade(g);
-    int grauMin = calcularGrauMinimo(g);
-    int grauMax = calcularGrauMaximo(g);
-
-    // Calcula matriz de distâncias para métricas mais complexas
-    vector<vector<long long>> matDist = floydWarshall(g);
-    long long diam = calcularDiametro(g, matDist);
-    float intermediacao = calcularIntermediacao(g, matDist);
-    double camMedio = calcularCaminhoMedio(g, matDist);
-
-    // Imprime a linha no arquivo CSV
-    outputFileCSV << nomeGrafoNoArquivo << ","
-                  << verticesReq << ","
-                  << arestasReq << ","
-                  << arcosReq << ","
-                  << dens << ","
-                  << grauMin << ","
-                  << grauMax << ","
-                  << (diam == LONGLONG_INF ? "INF" : std::to_string(diam)) << "," // Converte diâmetro para string, tratando INF
-                  << camMedio << ","
-                  << intermediacao
-                  << "\n";
+    MatrizDistancias matDist = floydWarshall(g);
+    escreverLinhaMetricas(outputFileCSV, nomeGrafoNoArquivo, calcularMetricas(g, matDist.visao()));
 }
 
 #endif // FUNCOES_HPP
@@ -0,0 +1,164 @@
+#ifndef GERADOR_INSTANCIAS_HPP
+#define GERADOR_INSTANCIAS_HPP
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+
+#include "grafo.hpp" // DadosInstancia, Grafo
+
+using namespace std;
+
+// Gerador de instâncias sintéticas no formato .dat lido por lerGrafoDeArquivo, para testar o programa em
+// tamanhos maiores que os do MCGRP.zip. A malha imita uma cidade: os nós formam uma grade de L x L (a última
+// linha pode ficar incompleta), as ruas verticais são arestas de mão dupla e cada rua horizontal é, com
+// probabilidade fracaoMaoUnica, uma sequência de arcos de mão única (sentido alternado entre linhas);
+// a primeira linha é sempre de mão dupla, então o grafo é fortemente conexo. A cada ESPACAMENTO_AVENIDAS
+// linhas/colunas há uma avenida, com custo de travessia reduzido. O depósito fica no centro da grade.
+
+const int ESPACAMENTO_AVENIDAS = 10;
+
+struct ConfigGerador
+{
+    int numNos = 1000;
+    double fracaoMaoUnica = 0.3;          // Ruas horizontais de mão única (arcos)
+    double fracaoNosRequeridos = 0.05;    // Fração dos nós com demanda
+    double fracaoArestasRequeridas = 0.3; // Fração das arestas com demanda
+    double fracaoArcosRequeridos = 0.3;   // Fração dos arcos com demanda
+    int custoMin = 20, custoMax = 60;     // Custo de travessia de uma quadra
+    int demandaMax = 10;                  // Demandas sorteadas em 1..demandaMax
+    int capacidade = 200;
+    unsigned long long semente = 1;
+};
+
+// Gera a instância (grafo congelado, depósito e capacidade) a partir da configuração.
+DadosInstancia gerarInstancia(const ConfigGerador &config, const string &nome)
+{
+    DadosInstancia dados;
+    dados.nomeInstancia = nome;
+    dados.capacidadeVeiculo = config.capacidade;
+    const int V = max(2, config.numNos);
+    const int L = static_cast<int>(ceil(sqrt(static_cast<double>(V))));
+    Grafo &g = dados.g;
+    g.inicializarGrafoInterno(V);
+
+    mt19937_64 gerador(config.semente);
+    uniform_real_distribution<double> sorteio(0.0, 1.0);
+    uniform_int_distribution<int> custoQuadra(config.custoMin, config.custoMax);
+    uniform_int_distribution<int> demanda(1, max(1, min(config.demandaMax, config.capacidade)));
+    auto id = [&](int linha, int coluna)
+    { return linha * L + coluna + 1; };
+    auto custo = [&](bool avenida)
+    { return avenida ? max(1, custoQuadra(gerador) / 2) : custoQuadra(gerador); };
+
+    for (int no = 1; no <= V; ++no)
+    {
+        if (sorteio(gerador) < config.fracaoNosRequeridos)
+            g.adicionarVertice(no, demanda(gerador), demanda(gerador));
+    }
+    for (int linha = 0; linha * L < V; ++linha)
+    {
+        const bool maoUnica = linha > 0 && sorteio(gerador) < config.fracaoMaoUnica;
+        const bool avenida = linha % ESPACAMENTO_AVENIDAS == 0;
+        for (int coluna = 0; coluna + 1 < L && id(linha, coluna + 1) <= V; ++coluna)
+        {
+            int u = id(linha, coluna), v = id(linha, coluna + 1), c = custo(avenida);
+            if (maoUnica)
+            {
+                if (linha % 2 == 1)
+                    swap(u, v);
+                if (sorteio(gerador) < config.fracaoArcosRequeridos)
+                {
+                    int d = demanda(gerador);
+                    g.adicionarArco(u, v, c, d, c + d);
+                }
+                else
+                    g.adicionarArco(u, v, c, 0, 0);
+            }
+            else if (sorteio(gerador) < config.fracaoArestasRequeridas)
+            {
+                int d = demanda(gerador);
+                g.adicionarAresta(u, v, c, d, c + d);
+            }
+            else
+                g.adicionarAresta(u, v, c, 0, 0);
+        }
+    }
+    for (int coluna = 0; coluna < L; ++coluna)
+    {
+        const bool avenida = coluna % ESPACAMENTO_AVENIDAS == 0;
+        for (int linha = 0; id(linha + 1, coluna) <= V; ++linha)
+        {
+            int c = custo(avenida);
+            if (sorteio(gerador) < config.fracaoArestasRequeridas)
+            {
+                int d = demanda(gerador);
+                g.adicionarAresta(id(linha, coluna), id(linha + 1, coluna), c, d, c + d);
+            }
+            else
+                g.adicionarAresta(id(linha, coluna), id(linha + 1, coluna), c, 0, 0);
+        }
+    }
+    dados.idNoDeposito = min(V, id(L / 2, L / 2));
+    g.congelar();
+    return dados;
+}
+
+// Grava a instância no formato .dat (cabeçalho, ReN., ReE., EDGE, ReA., ARC). Retorna false se não abrir.
+bool escreverInstancia(const string &nomeArquivo, const DadosInstancia &dados)
+{
+    ofstream arq(nomeArquivo);
+    if (!arq.is_open())
+        return false;
+    const Grafo &g = dados.g;
+    int nosReq = 0, arestasReq = 0, arcosReq = 0;
+    for (const auto &v : g.vertices)
+        nosReq += v.demanda > 0;
+    for (const auto &a : g.arestas)
+        arestasReq += a.demanda > 0;
+    for (const auto &a : g.arcos)
+        arcosReq += a.demanda > 0;
+
+    arq << "Name:\t\t" << dados.nomeInstancia << "\n"
+        << "Optimal value:\t-1\n"
+        << "#Vehicles:\t-1\n"
+        << "Capacity:\t" << dados.capacidadeVeiculo << "\n"
+        << "Depot Node:\t" << dados.idNoDeposito << "\n"
+        << "#Nodes:\t\t" << g.V << "\n"
+        << "#Edges:\t\t" << g.arestas.size() << "\n"
+        << "#Arcs:\t\t" << g.arcos.size() << "\n"
+        << "#Required N:\t" << nosReq << "\n"
+        << "#Required E:\t" << arestasReq << "\n"
+        << "#Required A:\t" << arcosReq << "\n\n";
+
+    arq << "ReN.\tDEMAND\tS. COST\n";
+    for (const auto &v : g.vertices)
+        if (v.demanda > 0)
+            arq << "N" << v.id << "\t" << v.demanda << "\t" << v.s_custo << "\n";
+    arq << "\nReE.\tFrom N.\tTo N.\tT. COST\tDEMAND\tS. COST\n";
+    int k = 0;
+    for (const auto &a : g.arestas)
+        if (a.demanda > 0)
+            arq << "E" << ++k << "\t" << a.origem << "\t" << a.destino << "\t" << a.custo << "\t" << a.demanda << "\t" << a.s_custo << "\n";
+    arq << "\nEDGE\tFROM N.\tTO N.\tT. COST\n";
+    k = 0;
+    for (const auto &a : g.arestas)
+        if (a.demanda <= 0)
+            arq << "NrE" << ++k << "\t" << a.origem << "\t" << a.destino << "\t" << a.custo << "\n";
+    arq << "\nReA.\tFROM N.\tTO N.\tT. COST\tDEMAND\tS. COST\n";
+    k = 0;
+    for (const auto &a : g.arcos)
+        if (a.demanda > 0)
+            arq << "A" << ++k << "\t" << a.origem << "\t" << a.destino << "\t" << a.custo << "\t" << a.demanda << "\t" << a.s_custo << "\n";
+    arq << "\nARC\tFROM N.\tTO N.\tT. COST\n";
+    k = 0;
+    for (const auto &a : g.arcos)
+        if (a.demanda <= 0)
+            arq << "NrA" << ++k << "\t" << a.origem << "\t" << a.destino << "\t" << a.custo << "\n";
+    return static_cast<bool>(arq);
+}
+
+#endif // GERADOR_INSTANCIAS_HPP
@@ -36,34 +36,56 @@ struct Vertice
     int s_custo; // Custo associado ao serviço do vértice
 };
 
+// Adjacência do grafo misto em formato CSR (compressed sparse row), montada uma única vez após a leitura.
+// Os sucessores de u ficam contíguos em sucessores[inicio[u] .. inicio[u+1]): primeiro as arestas (que
+// aparecem nas duas extremidades), depois os arcos de saída, cada um como o par (destino, custo). Em vez de
+// uma alocação por nó e um ponteiro por vizinho, Dijkstra e travessias leem um único vetor em sequência.
+struct AdjacenciaCSR
+{
+    struct Sucessor
+    {
+        int destino;
+        int custo;
+    };
+
+    // Faixa [ini, fim) dos sucessores de um nó, para uso em laços "for (const auto &s : ...)".
+    struct Faixa
+    {
+        const Sucessor *ini, *fim;
+
+        const Sucessor *begin() const { return ini; }
+        const Sucessor *end() const { return fim; }
+        int tamanho() const { return static_cast<int>(fim - ini); }
+    };
+
+    vector<int> inicio;          // V+2 posições: sucessores de u em [inicio[u], inicio[u+1])
+    vector<int> fimArestas;      // V+1 posições: as arestas de u terminam em fimArestas[u] (depois vêm os arcos)
+    vector<Sucessor> sucessores; // Arestas nos dois sentidos e arcos, agrupados pelo nó de origem
+
+    Faixa de(int u) const { return {sucessores.data() + inicio[u], sucessores.data() + inicio[u + 1]}; }
+    Faixa arestasDe(int u) const { return {sucessores.data() + inicio[u], sucessores.data() + fimArestas[u]}; }
+    int grauArestas(int u) const { return fimArestas[u] - inicio[u]; }
+};
+
 // Classe que representa o grafo e suas operações básicas.
 class Grafo
 {
 public:
-    int V;                                     // Número total de vértices no grafo
-    vector<vector<pair<int, int>>> adjArestas; // Lista de adjacência para arestas
-    vector<vector<pair<int, int>>> adjArcos;   // Lista de adjacência para arcos
+    int V;                    // Número total de vértices no grafo
+    AdjacenciaCSR adjacencia; // Adjacência compacta de arestas e arcos, válida após congelar()
 
     vector<Vertice> vertices; // Lista de vértices (geralmente os nós com serviços)
     vector<Aresta> arestas;   // Lista de todas as arestas do grafo
     vector<Arco> arcos;       // Lista de todos os arcos do grafo
 
     // Construtor: inicializa um grafo com um número opcional de vértices.
-    Grafo(int num_vertices = 0) : V(num_vertices)
-    {
-        if (V > 0)
-        {
-            adjArestas.resize(V + 1); // Usa indexação baseada em 1
-            adjArcos.resize(V + 1);
-        }
-    }
+    Grafo(int num_vertices = 0) : V(num_vertices) {}
 
     // (Re)inicializa o grafo com um novo número de vértices, limpando dados antigos.
     void inicializarGrafoInterno(int num_vertices)
     {
         V = num_vertices;
-        adjArestas.assign(V + 1, vector<pair<int, int>>());
-        adjArcos.assign(V + 1, vector<pair<int, int>>());
+        adjacencia = AdjacenciaCSR();
         vertices.clear();
         arestas.clear();
         arcos.clear();
@@ -75,27 +97,71 @@ public:
         vertices.push_back({id_no, demanda_no, s_custo_no});
     }
 
-    // Adiciona uma aresta ao grafo e atualiza as listas de adjacência (bidirecional).
+    // Adiciona uma aresta (bidirecional) ao grafo. A adjacência só é atualizada em congelar().
     void adicionarAresta(int origem, int destino, int custo, int demanda, int s_custo)
     {
         arestas.push_back({origem, destino, custo, demanda, s_custo});
-        // Adiciona às listas de adjacência se os nós estiverem dentro dos limites de V
-        if (origem > 0 && origem <= V && destino > 0 && destino <= V)
-        {
-            adjArestas[origem].push_back({destino, custo});
-            adjArestas[destino].push_back({origem, custo});
-        }
     }
 
-    // Adiciona um arco ao grafo e atualiza a lista de adjacência (direcional).
+    // Adiciona um arco (direcional) ao grafo. A adjacência só é atualizada em congelar().
     void adicionarArco(int origem, int destino, int custo, int demanda, int s_custo)
     {
         arcos.push_back({origem, destino, custo, demanda, s_custo});
-        // Adiciona à lista de adjacência se os nós estiverem dentro dos limites de V
-        if (origem > 0 && origem <= V && destino > 0 && destino <= V)
+    }
+
+    // Monta a adjacência CSR a partir das listas de arestas e arcos (contagem + prefixos, O(V + E)).
+    // Deve ser chamada ao fim da leitura, depois da última aresta ou arco adicionado; ligações com nós
+    // fora de 1..V são ignoradas. A ordem dos sucessores de cada nó segue a ordem de inserção.
+    void congelar()
+    {
+        auto valido = [&](int no)
+        { return no > 0 && no <= V; };
+        AdjacenciaCSR &adj = adjacencia;
+        adj.inicio.assign(V + 2, 0);
+        adj.fimArestas.assign(V + 1, 0);
+
+        // Graus de saída (arestas e arcos separados) em inicio[u + 1] e fimArestas[u]
+        for (const auto &a : arestas)
+        {
+            if (valido(a.origem) && valido(a.destino))
+            {
+                adj.fimArestas[a.origem]++;
+                adj.fimArestas[a.destino]++;
+            }
+        }
+        for (int u = 1; u <= V; ++u)
+            adj.inicio[u + 1] = adj.fimArestas[u];
+        for (const auto &a : arcos)
+        {
+            if (valido(a.origem) && valido(a.destino))
+                adj.inicio[a.origem + 1]++;
+        }
+        for (int u = 1; u <= V; ++u)
+        {
+            adj.inicio[u + 1] += adj.inicio[u];
+            adj.fimArestas[u] += adj.inicio[u];
+        }
+        adj.sucessores.resize(adj.inicio[V + 1]);
+
+        // Preenchimento de trás para frente usando inicio[u+1] como cursor (sem vetor auxiliar, para que um
+        // grafo reaproveitado entre instâncias não aloque nada): arcos e depois arestas, percorridos em ordem
+        // inversa, mantêm a ordem das listas em cada nó. Ao final, inicio[u+1] aponta para o início de u.
+        for (auto a = arcos.rbegin(); a != arcos.rend(); ++a)
         {
-            adjArcos[origem].push_back({destino, custo});
+            if (valido(a->origem) && valido(a->destino))
+                adj.sucessores[--adj.inicio[a->origem + 1]] = {a->destino, a->custo};
         }
+        for (auto a = arestas.rbegin(); a != arestas.rend(); ++a)
+        {
+            if (valido(a->origem) && valido(a->destino))
+            {
+                adj.sucessores[--adj.inicio[a->destino + 1]] = {a->origem, a->custo};
+                adj.sucessores[--adj.inicio[a->origem + 1]] = {a->destino, a->custo};
+            }
+        }
+        for (int u = 0; u <= V; ++u)
+            adj.inicio[u] = adj.inicio[u + 1];
+        adj.inicio[V + 1] = static_cast<int>(adj.sucessores.size());
     }
 };
 
@@ -117,6 +183,8 @@ struct Servico
     int custoTravessia; // Custo t_custo para atravessar a aresta/arco (se aplicável)
     bool atendido;
     int p1Saida, p2Saida; // Nós de saída para formatação da solução (S id, p1, p2)
+    int chaveU = 0;       // Nó-chave remapeado de uOriginal (ou do nó, se tipo NO); 0 se inválido
+    int chaveV = 0;       // Nó-chave remapeado de vOriginal (ou do nó, se tipo NO); 0 se inválido
 };
 
 // Agrupa todos os dados relevantes lidos de um arquivo de instância.
@@ -146,8 +214,52 @@ string extrairNomeBaseInstancia(const string &caminhoArquivo)
     return nomeComExtensao;
 }
 
+// Contagens declaradas no cabeçalho de um arquivo de instância.
+struct CabecalhoInstancia
+{
+    int numNos = 0, numArestas = 0, numArcos = 0;
+    int numNosRequeridos = 0, numArestasRequeridas = 0, numArcosRequeridos = 0;
+
+    int numServicos() const { return numNosRequeridos + numArestasRequeridas + numArcosRequeridos; }
+};
+
+// Lê apenas o cabeçalho de um arquivo de instância (até o início da primeira seção de dados).
+// Usado para estimar o tamanho da instância sem fazer o parsing completo.
+CabecalhoInstancia lerCabecalhoInstancia(const string &nomeArquivo)
+{
+    CabecalhoInstancia cab;
+    ifstream arquivo(nomeArquivo);
+    string linha;
+    while (getline(arquivo, linha))
+    {
+        istringstream ssLinha(linha);
+        string chavePrimaria, tipoRequerido;
+        ssLinha >> chavePrimaria;
+        if (chavePrimaria == "#Nodes:")
+            ssLinha >> cab.numNos;
+        else if (chavePrimaria == "#Edges:")
+            ssLinha >> cab.numArestas;
+        else if (chavePrimaria == "#Arcs:")
+            ssLinha >> cab.numArcos;
+        else if (chavePrimaria == "#Required")
+        {
+            ssLinha >> tipoRequerido;
+            if (tipoRequerido == "N:")
+                ssLinha >> cab.numNosRequeridos;
+            else if (tipoRequerido == "E:")
+                ssLinha >> cab.numArestasRequeridas;
+            else if (tipoRequerido == "A:")
+                ssLinha >> cab.numArcosRequeridos;
+        }
+        else if (chavePrimaria == "ReN." || chavePrimaria == "ReE." || chavePrimaria == "ReA.")
+            break; // Fim do cabeçalho
+    }
+    return cab;
+}
+
 // Lê um arquivo de instância no formato .dat e retorna uma estrutura DadosInstancia.
-DadosInstancia lerGrafoDeArquivo(const string &nomeArquivo)
+// Os erros de abertura e de parsing são escritos em erros.
+DadosInstancia lerGrafoDeArquivo(const string &nomeArquivo, ostream &erros = cerr)
 {
     DadosInstancia dadosRetorno;
     dadosRetorno.idNoDeposito = -1;
@@ -157,7 +269,7 @@ DadosInstancia lerGrafoDeArquivo(const string &nomeArquivo)
     ifstream arquivo(nomeArquivo);
     if (!arquivo.is_open())
     {
-        cerr << "Erro ao abrir o arquivo: " << nomeArquivo << endl;
+        erros << "Erro ao abrir o arquivo: " << nomeArquivo << endl;
         return dadosRetorno;
     }
 
@@ -228,7 +340,7 @@ DadosInstancia lerGrafoDeArquivo(const string &nomeArquivo)
                 }
                 catch (const std::exception &e)
                 {
-                    cerr << "Erro parse ReN: " << linha << " (" << e.what() << ")" << endl;
+                    erros << "Erro parse ReN: " << linha << " (" << e.what() << ")" << endl;
                 }
             }
         }
@@ -258,7 +370,20 @@ DadosInstancia lerGrafoDeArquivo(const string &nomeArquivo)
                 dadosRetorno.g.adicionarArco(origem, destino, tCusto, demandaArco, sCustoArco);
             }
         }
-        else if (chavePrimaria == "ARCS" || (chavePrimaria == "ARC" && linha.length() == 3))
+        else if (chavePrimaria == "EDGE" || chavePrimaria == "EDGES")
+        { // Arestas não requeridas
+            while (getline(arquivo, linha) && !linha.empty())
+            {
+                istringstream ssDados(linha);
+                string idArestaNaoReqStr;
+                int origem, destino, tCusto;
+                ssDados >> idArestaNaoReqStr >> origem >> destino >> tCusto;
+                if (ssDados.fail() || idArestaNaoReqStr.empty())
+                    break;
+                dadosRetorno.g.adicionarAresta(origem, destino, tCusto, 0, 0); // Demanda e s_custo são 0
+            }
+        }
+        else if (chavePrimaria == "ARCS" || chavePrimaria == "ARC")
         { // Arcos não requeridos
             while (getline(arquivo, linha) && !linha.empty())
             {
@@ -273,6 +398,7 @@ DadosInstancia lerGrafoDeArquivo(const string &nomeArquivo)
         }
     }
     arquivo.close();
+    dadosRetorno.g.congelar();
     return dadosRetorno;
 }
 
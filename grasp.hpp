@@ -0,0 +1,243 @@
+#ifndef GRASP_HPP
+#define GRASP_HPP
+
+#include <vector>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <climits>
+
+#include "grafo.hpp"             // Servico
+#include "matriz_distancias.hpp" // VisaoMatrizDistancias, LONGLONG_INF
+#include "candidatos.hpp"        // avaliarServico, AvaliacaoServico, ServicosSoA
+#include "solucao.hpp"           // Solucao, Rota, Visita
+#include "busca_local.hpp"       // BuscaLocal, ConfigBuscaLocal
+#include "pool_threads.hpp"      // PoolThreads
+
+using namespace std;
+
+// GRASP paralelo: várias threads constroem soluções em paralelo com o construtivo do vizinho mais próximo
+// randomizado. A cada passo, o serviço é sorteado em uma lista restrita de candidatos (RCL): os k mais baratos,
+// ou os de custo até cmin + alfa (cmax - cmin). Cada solução passa pela busca local (se ativa).
+// Cada construção i usa um gerador com a semente (semente, i) e cada thread trabalha em buffers próprios.
+// O resultado final é a menor (custo, i) entre todas as construções, então a solução depende apenas da semente
+// e do número de construções, e não da ordem de execução das threads. O único estado compartilhado durante a
+// busca é o melhor custo global, atualizado com compare-and-swap; sem busca local ele descarta cedo as
+// construções parciais que já custam mais que a melhor solução.
+
+const int TAMANHO_RCL = 3;
+
+struct ConfigGrasp
+{
+    int construcoes = 0;            // Soluções construídas (0 = GRASP desligado)
+    int numThreads = 0;             // Threads das construções (0 = número de núcleos)
+    int tamanhoRCL = TAMANHO_RCL;   // RCL com os k candidatos mais baratos
+    double alfa = -1;               // Se >= 0, RCL por limiar de custo (substitui tamanhoRCL)
+    unsigned long long semente = 1; // Semente dos geradores pseudoaleatórios
+};
+
+struct ResultadoGrasp
+{
+    long long custoInicial = 0;
+    int melhorConstrucao = -1; // Construção que gerou a solução final (-1 = a solução inicial foi mantida)
+    int numThreads = 0;
+    chrono::high_resolution_clock::time_point momentoMelhor;
+};
+
+class Grasp
+{
+public:
+    Grasp(const vector<Servico> &servicos_, VisaoMatrizDistancias dist_, int chaveDeposito_, int capacidade_,
+          const ConfigBuscaLocal &configBL_, const ConfigGrasp &config_)
+        : servicos(servicos_), soa(servicos_), dist(dist_), chaveDeposito(chaveDeposito_), capacidade(capacidade_),
+          configBL(configBL_), config(config_) {}
+
+    // Executa as construções e substitui solucao pela melhor construção, se alguma for estritamente melhor.
+    ResultadoGrasp executar(Solucao &solucao)
+    {
+        ResultadoGrasp resultado;
+        resultado.custoInicial = solucao.custoTotal;
+        if (config.construcoes <= 0 || servicos.empty() || chaveDeposito <= 0)
+            return resultado;
+
+        PoolThreads pool(min(resolverNumThreads(config.numThreads), config.construcoes));
+        const int numThreads = pool.tamanho();
+        melhorCustoGlobal.store(solucao.custoTotal);
+        proximaConstrucao.store(0);
+        resultado.numThreads = numThreads;
+        vector<MelhorDaThread> melhores(numThreads);
+
+        // Cada tarefa é uma thread, que consome construções até acabarem
+        pool.executarParalelo(numThreads, [&](int t)
+                              {
+            AreaTrabalho area;
+            unique_ptr<BuscaLocal> buscaLocal;
+            if (configBL.modo != ModoBuscaLocal::NENHUMA)
+                buscaLocal = make_unique<BuscaLocal>(servicos, dist, chaveDeposito, capacidade, configBL);
+            MelhorDaThread &melhor = melhores[t];
+
+            for (int i = proximaConstrucao.fetch_add(1); i < config.construcoes; i = proximaConstrucao.fetch_add(1))
+            {
+                seed_seq sementes{static_cast<unsigned>(config.semente), static_cast<unsigned>(config.semente >> 32),
+                                  static_cast<unsigned>(i)};
+                area.gerador.seed(sementes);
+                if (!construir(area, !buscaLocal))
+                    continue;
+                if (buscaLocal)
+                    buscaLocal->otimizar(area.solucao);
+
+                if (area.solucao.custoTotal < melhor.solucao.custoTotal ||
+                    (area.solucao.custoTotal == melhor.solucao.custoTotal && i < melhor.construcao))
+                {
+                    melhor.solucao = area.solucao;
+                    melhor.construcao = i;
+                    melhor.momento = chrono::high_resolution_clock::now();
+                    long long atual = melhorCustoGlobal.load(memory_order_relaxed);
+                    while (melhor.solucao.custoTotal < atual &&
+                           !melhorCustoGlobal.compare_exchange_weak(atual, melhor.solucao.custoTotal, memory_order_relaxed))
+                    {
+                    }
+                }
+            } });
+
+        // Redução determinística: menor custo e, em caso de empate, menor índice de construção
+        const MelhorDaThread *vencedor = nullptr;
+        for (const MelhorDaThread &m : melhores)
+        {
+            if (m.construcao >= 0 && (!vencedor || m.solucao.custoTotal < vencedor->solucao.custoTotal ||
+                                      (m.solucao.custoTotal == vencedor->solucao.custoTotal && m.construcao < vencedor->construcao)))
+                vencedor = &m;
+        }
+        if (vencedor && vencedor->solucao.custoTotal < solucao.custoTotal)
+        {
+            solucao = vencedor->solucao;
+            resultado.melhorConstrucao = vencedor->construcao;
+            resultado.momentoMelhor = vencedor->momento;
+        }
+        return resultado;
+    }
+
+private:
+    struct AreaTrabalho
+    {
+        mt19937_64 gerador;
+        vector<int> pendentes;                 // Serviços ainda não atendidos (remoção por troca com o último)
+        vector<pair<long long, int>> rcl;      // (custo, posição em pendentes)
+        Solucao solucao;
+    };
+
+    struct MelhorDaThread
+    {
+        Solucao solucao;
+        int construcao = -1;
+        chrono::high_resolution_clock::time_point momento;
+
+        MelhorDaThread() { solucao.custoTotal = LLONG_MAX; }
+    };
+
+    // Monta a RCL a partir da posição atual com os serviços pendentes que cabem na capacidade restante.
+    void montarRCL(AreaTrabalho &area, int chavePos, long long capacidadeRestante) const
+    {
+        const long long *linha = dist.linha(chavePos);
+        area.rcl.clear();
+        const bool porLimiar = config.alfa >= 0;
+        const size_t k = static_cast<size_t>(config.tamanhoRCL);
+        for (int p = 0; p < static_cast<int>(area.pendentes.size()); ++p)
+        {
+            const int indice = area.pendentes[p];
+            if (soa.demanda[indice] > capacidadeRestante)
+                continue;
+            long long custo = soa.custo(indice, linha);
+            if (custo == LONGLONG_INF)
+                continue;
+            if (porLimiar)
+            {
+                area.rcl.push_back({custo, p});
+                continue;
+            }
+            // Top-k ordenado por (custo, índice do serviço), para não depender da ordem dos pendentes
+            auto menor = [&](const pair<long long, int> &x, const pair<long long, int> &y)
+            { return x.first != y.first ? x.first < y.first : area.pendentes[x.second] < area.pendentes[y.second]; };
+            pair<long long, int> candidato{custo, p};
+            if (area.rcl.size() == k && !menor(candidato, area.rcl.back()))
+                continue;
+            if (area.rcl.size() == k)
+                area.rcl.pop_back();
+            area.rcl.insert(upper_bound(area.rcl.begin(), area.rcl.end(), candidato, menor), candidato);
+        }
+        if (porLimiar && !area.rcl.empty())
+        {
+            long long cmin = LLONG_MAX, cmax = LLONG_MIN;
+            for (const auto &c : area.rcl)
+            {
+                cmin = min(cmin, c.first);
+                cmax = max(cmax, c.first);
+            }
+            const double limiar = cmin + config.alfa * (cmax - cmin);
+            area.rcl.erase(remove_if(area.rcl.begin(), area.rcl.end(), [&](const pair<long long, int> &c)
+                                     { return c.first > limiar; }),
+                           area.rcl.end());
+            // Ordem canônica (índice do serviço) para o sorteio não depender da ordem dos pendentes
+            sort(area.rcl.begin(), area.rcl.end(), [&](const pair<long long, int> &x, const pair<long long, int> &y)
+                 { return area.pendentes[x.second] < area.pendentes[y.second]; });
+        }
+    }
+
+    // Constrói uma solução em area.solucao. Retorna false se algum serviço não puder ser atendido, se alguma
+    // rota não puder voltar ao depósito ou (com podar) se o custo parcial passar do melhor custo global.
+    bool construir(AreaTrabalho &area, bool podar) const
+    {
+        area.pendentes.resize(servicos.size());
+        for (int i = 0; i < static_cast<int>(servicos.size()); ++i)
+            area.pendentes[i] = i;
+        area.solucao.rotas.clear();
+        area.solucao.custoTotal = 0;
+
+        while (!area.pendentes.empty())
+        {
+            Rota rota;
+            int chavePos = chaveDeposito;
+            while (true)
+            {
+                montarRCL(area, chavePos, capacidade - rota.demanda);
+                if (area.rcl.empty())
+                    break;
+                int p = area.rcl[uniform_int_distribution<int>(0, static_cast<int>(area.rcl.size()) - 1)(area.gerador)].second;
+                int indice = area.pendentes[p];
+                area.pendentes[p] = area.pendentes.back();
+                area.pendentes.pop_back();
+
+                AvaliacaoServico aval = avaliarServico(servicos[indice], LinhaDistancias{dist.linha(chavePos)});
+                rota.visitas.push_back({indice, aval.invertido});
+                rota.demanda += servicos[indice].demanda;
+                rota.custo += aval.custo;
+                chavePos = aval.chavePosFinal;
+            }
+            if (rota.visitas.empty())
+                return false; // Nenhum pendente alcançável a partir do depósito
+            if (dist(chavePos, chaveDeposito) == LONGLONG_INF)
+                return false;
+            rota.custo += dist(chavePos, chaveDeposito);
+            area.solucao.custoTotal += rota.custo;
+            area.solucao.rotas.push_back(std::move(rota));
+            if (podar && area.solucao.custoTotal > melhorCustoGlobal.load(memory_order_relaxed))
+                return false;
+        }
+        return true;
+    }
+
+    const vector<Servico> &servicos;
+    ServicosSoA soa; // Campos usados na montagem da RCL, em vetores contíguos
+    VisaoMatrizDistancias dist;
+    int chaveDeposito;
+    long long capacidade;
+    ConfigBuscaLocal configBL;
+    ConfigGrasp config;
+
+    atomic<long long> melhorCustoGlobal{LLONG_MAX};
+    atomic<int> proximaConstrucao{0};
+};
+
+#endif // GRASP_HPP
@@ -0,0 +1,168 @@
+#ifndef INTERMEDIACAO_HPP
+#define INTERMEDIACAO_HPP
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <cstdint>
+#include <bitset>
+
+#include "grafo.hpp"             // Grafo (adjacência CSR)
+#include "matriz_distancias.hpp" // DIST_INF_SATURADO
+#include "pool_threads.hpp"      // PoolThreads, resolverNumThreads
+
+using namespace std;
+
+// Intermediação pelo algoritmo de Brandes, sem matriz de distâncias: um Dijkstra por origem s sobre
+// a adjacência CSR (arestas nos dois sentidos e arcos), seguido de uma passada em ordem reversa de distância sobre o
+// DAG de caminhos mínimos (arcos u->w com d(s,u) + c = d(s,w)). Para cada origem são obtidos:
+//   - a dependência de Brandes, delta_s(v) = soma sobre t de sigma_st(v) / sigma_st (intermediação por nó);
+//   - os descendentes de cada v no DAG, em bitsets: são exatamente os t com d(s,v) + d(v,t) = d(s,t), ou seja,
+//     os pares da métrica "intermediação média" do CSV (nós em algum caminho mínimo s-t / pares alcançáveis).
+// As origens são divididas em faixas fixas entre as threads, cada uma com seus próprios acumuladores,
+// somados ao final na ordem das faixas (o resultado não depende do escalonamento).
+// Custo O(V (E log V + E V/64)) em vez do O(V^3) da verificação de todas as triplas (s, v, t).
+
+struct ResultadoIntermediacao
+{
+    vector<double> porNo;          // Intermediação de Brandes de cada nó (1..V), sobre pares ordenados (s, t)
+    long long triplas = 0;         // Triplas (s, v, t) distintas com v em algum caminho mínimo de s a t
+    long long paresAlcancaveis = 0; // Pares ordenados (s, t), s != t, com caminho
+
+    // Valor da coluna de intermediação do CSV.
+    double media() const { return paresAlcancaveis > 0 ? static_cast<double>(triplas) / paresAlcancaveis : 0.0; }
+};
+
+ResultadoIntermediacao calcularIntermediacaoBrandes(const Grafo &g, int numThreads = 0)
+{
+    const int n = g.V;
+    ResultadoIntermediacao resultado;
+    resultado.porNo.assign(n + 1, 0.0);
+    if (n < 3)
+        return resultado;
+
+    // Com arcos de custo zero o DAG pode ter ciclos entre nós de mesma distância; nesse caso a propagação dos
+    // descendentes é repetida até estabilizar.
+    bool temCustoZero = false;
+    for (const auto &suc : g.adjacencia.sucessores)
+        temCustoZero = temCustoZero || suc.custo == 0;
+
+    PoolThreads pool(min(resolverNumThreads(numThreads), n));
+    const int numFaixas = pool.tamanho();
+    vector<vector<double>> intermediacaoFaixa(numFaixas);
+    vector<long long> triplasFaixa(numFaixas, 0), paresFaixa(numFaixas, 0);
+    const int palavras = (n + 1 + 63) / 64;
+
+    pool.executarParalelo(numFaixas, [&](int faixa)
+                          {
+        vector<double> &acumulado = intermediacaoFaixa[faixa];
+        acumulado.assign(n + 1, 0.0);
+        vector<long long> dist(n + 1);
+        vector<double> sigma(n + 1), delta(n + 1);
+        vector<int> ordem;
+        ordem.reserve(n);
+        vector<uint64_t> descendentes(static_cast<size_t>(n + 1) * palavras);
+        using ItemHeap = pair<long long, int>;
+        priority_queue<ItemHeap, vector<ItemHeap>, greater<ItemHeap>> heap;
+
+        // Percorre os sucessores de u (arestas nos dois sentidos e arcos de saída)
+        auto paraCadaSucessor = [&](int u, auto &&visitar)
+        {
+            for (const auto &suc : g.adjacencia.de(u))
+                visitar(suc.destino, static_cast<long long>(suc.custo));
+        };
+
+        const int inicio = static_cast<int>(static_cast<long long>(n) * faixa / numFaixas) + 1;
+        const int fim = static_cast<int>(static_cast<long long>(n) * (faixa + 1) / numFaixas);
+        for (int s = inicio; s <= fim; ++s)
+        {
+            // Dijkstra registrando a ordem de fixação dos nós
+            fill(dist.begin(), dist.end(), DIST_INF_SATURADO);
+            ordem.clear();
+            dist[s] = 0;
+            heap.push({0, s});
+            while (!heap.empty())
+            {
+                const long long d = heap.top().first;
+                const int u = heap.top().second;
+                heap.pop();
+                if (d > dist[u])
+                    continue;
+                ordem.push_back(u);
+                paraCadaSucessor(u, [&](int w, long long c)
+                                 {
+                    if (d + c < dist[w])
+                    {
+                        dist[w] = d + c;
+                        heap.push({dist[w], w});
+                    } });
+            }
+
+            // Número de caminhos mínimos (sigma), na ordem de fixação
+            for (int u : ordem)
+                sigma[u] = 0;
+            sigma[s] = 1;
+            for (int u : ordem)
+                paraCadaSucessor(u, [&](int w, long long c)
+                                 {
+                    if (w != s && dist[u] + c == dist[w])
+                        sigma[w] += sigma[u]; });
+
+            // Dependências de Brandes e descendentes no DAG, em ordem reversa
+            for (int u : ordem)
+            {
+                delta[u] = 0;
+                fill_n(descendentes.begin() + static_cast<size_t>(u) * palavras, palavras, 0);
+            }
+            bool mudou = true;
+            for (int passada = 0; mudou; ++passada)
+            {
+                mudou = false;
+                for (auto it = ordem.rbegin(); it != ordem.rend(); ++it)
+                {
+                    const int u = *it;
+                    uint64_t *descU = &descendentes[static_cast<size_t>(u) * palavras];
+                    paraCadaSucessor(u, [&](int w, long long c)
+                                     {
+                        if (w == s || dist[u] + c != dist[w])
+                            return;
+                        if (passada == 0 && sigma[w] > 0)
+                            delta[u] += sigma[u] / sigma[w] * (1.0 + delta[w]);
+                        const uint64_t *descW = &descendentes[static_cast<size_t>(w) * palavras];
+                        for (int p = 0; p < palavras; ++p)
+                        {
+                            uint64_t novo = descU[p] | descW[p] | (p == (w >> 6) ? uint64_t(1) << (w & 63) : 0);
+                            mudou = mudou || novo != descU[p];
+                            descU[p] = novo;
+                        } });
+                }
+                mudou = mudou && temCustoZero;
+            }
+
+            paresFaixa[faixa] += static_cast<long long>(ordem.size()) - 1;
+            for (int v : ordem)
+            {
+                if (v == s)
+                    continue;
+                acumulado[v] += delta[v];
+                const uint64_t *descV = &descendentes[static_cast<size_t>(v) * palavras];
+                long long cont = 0;
+                for (int p = 0; p < palavras; ++p)
+                    cont += bitset<64>(descV[p]).count();
+                cont -= (descV[s >> 6] >> (s & 63)) & 1; // t != s
+                cont -= (descV[v >> 6] >> (v & 63)) & 1; // t != v
+                triplasFaixa[faixa] += cont;
+            }
+        } });
+
+    for (int f = 0; f < numFaixas; ++f)
+    {
+        for (int v = 1; v <= n; ++v)
+            resultado.porNo[v] += intermediacaoFaixa[f][v];
+        resultado.triplas += triplasFaixa[f];
+        resultado.paresAlcancaveis += paresFaixa[f];
+    }
+    return resultado;
+}
+
+#endif // INTERMEDIACAO_HPP
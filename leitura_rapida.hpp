@@ -0,0 +1,373 @@
+#ifndef LEITURA_RAPIDA_HPP
+#define LEITURA_RAPIDA_HPP
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "grafo.hpp" // DadosInstancia, CabecalhoInstancia, extrairNomeBaseInstancia
+
+using namespace std;
+
+// Arquivo mapeado em memória somente para leitura (RAII). O conteúdo é acessado sem cópias.
+class ArquivoMapeado
+{
+public:
+    ArquivoMapeado(const string &nomeArquivo)
+    {
+#ifdef _WIN32
+        hArquivo = CreateFileA(nomeArquivo.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (hArquivo == INVALID_HANDLE_VALUE)
+            return;
+        LARGE_INTEGER tam;
+        if (!GetFileSizeEx(hArquivo, &tam))
+            return;
+        tamanhoBytes = static_cast<size_t>(tam.QuadPart);
+        aberto = true;
+        if (tamanhoBytes == 0)
+            return;
+        hMapeamento = CreateFileMappingA(hArquivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (hMapeamento == nullptr)
+        {
+            aberto = false;
+            return;
+        }
+        inicio = static_cast<const char *>(MapViewOfFile(hMapeamento, FILE_MAP_READ, 0, 0, 0));
+        aberto = inicio != nullptr;
+#else
+        descritor = open(nomeArquivo.c_str(), O_RDONLY);
+        if (descritor < 0)
+            return;
+        struct stat info;
+        if (fstat(descritor, &info) != 0)
+            return;
+        tamanhoBytes = static_cast<size_t>(info.st_size);
+        aberto = true;
+        if (tamanhoBytes == 0)
+            return; // mmap não aceita tamanho 0; um arquivo vazio é simplesmente um texto vazio
+        void *p = mmap(nullptr, tamanhoBytes, PROT_READ, MAP_PRIVATE, descritor, 0);
+        if (p == MAP_FAILED)
+        {
+            aberto = false;
+            return;
+        }
+        madvise(p, tamanhoBytes, MADV_SEQUENTIAL);
+        inicio = static_cast<const char *>(p);
+#endif
+    }
+
+    ~ArquivoMapeado()
+    {
+#ifdef _WIN32
+        if (inicio)
+            UnmapViewOfFile(inicio);
+        if (hMapeamento)
+            CloseHandle(hMapeamento);
+        if (hArquivo != INVALID_HANDLE_VALUE)
+            CloseHandle(hArquivo);
+#else
+        if (inicio)
+            munmap(const_cast<char *>(inicio), tamanhoBytes);
+        if (descritor >= 0)
+            close(descritor);
+#endif
+    }
+
+    ArquivoMapeado(const ArquivoMapeado &) = delete;
+    ArquivoMapeado &operator=(const ArquivoMapeado &) = delete;
+
+    bool estaAberto() const { return aberto; }
+    const char *dados() const { return inicio; }
+    size_t tamanho() const { return tamanhoBytes; }
+
+private:
+    const char *inicio = nullptr;
+    size_t tamanhoBytes = 0;
+    bool aberto = false;
+#ifdef _WIN32
+    HANDLE hArquivo = INVALID_HANDLE_VALUE;
+    HANDLE hMapeamento = nullptr;
+#else
+    int descritor = -1;
+#endif
+};
+
+// Estatísticas de uma leitura (bytes processados e tempo gasto no parsing).
+struct EstatisticasLeitura
+{
+    size_t bytes = 0;
+    double segundos = 0.0;
+
+    double mbPorSegundo() const { return segundos > 0.0 ? (bytes / (1024.0 * 1024.0)) / segundos : 0.0; }
+};
+
+// Retira a próxima linha de texto (sem o '\n' e um eventual '\r') e avança o cursor.
+inline bool proximaLinha(string_view &texto, string_view &linha)
+{
+    if (texto.empty())
+        return false;
+    size_t fimLinha = texto.find('\n');
+    size_t avanco = fimLinha == string_view::npos ? texto.size() : fimLinha + 1;
+    linha = texto.substr(0, fimLinha == string_view::npos ? texto.size() : fimLinha);
+    if (!linha.empty() && linha.back() == '\r')
+        linha.remove_suffix(1);
+    texto.remove_prefix(avanco);
+    return true;
+}
+
+// Retira o próximo token (separado por espaços ou tabulações) da linha. Retorna vazio no fim da linha.
+inline string_view proximoToken(string_view &linha)
+{
+    size_t i = 0;
+    while (i < linha.size() && (linha[i] == ' ' || linha[i] == '\t'))
+        i++;
+    size_t j = i;
+    while (j < linha.size() && linha[j] != ' ' && linha[j] != '\t')
+        j++;
+    string_view token = linha.substr(i, j - i);
+    linha.remove_prefix(j);
+    return token;
+}
+
+// Converte o próximo token da linha em inteiro com from_chars. Retorna false se faltar ou for inválido.
+inline bool lerInteiro(string_view &linha, int &valor)
+{
+    string_view token = proximoToken(linha);
+    if (token.empty())
+        return false;
+    auto [fim, erro] = from_chars(token.data(), token.data() + token.size(), valor);
+    return erro == errc() && fim == token.data() + token.size();
+}
+
+// Lê apenas as contagens do cabeçalho de uma instância já em memória (até a primeira seção de dados).
+CabecalhoInstancia lerCabecalhoDeMemoria(string_view texto)
+{
+    CabecalhoInstancia cab;
+    string_view linha;
+    while (proximaLinha(texto, linha))
+    {
+        string_view chavePrimaria = proximoToken(linha);
+        if (chavePrimaria == "#Nodes:")
+            lerInteiro(linha, cab.numNos);
+        else if (chavePrimaria == "#Edges:")
+            lerInteiro(linha, cab.numArestas);
+        else if (chavePrimaria == "#Arcs:")
+            lerInteiro(linha, cab.numArcos);
+        else if (chavePrimaria == "#Required")
+        {
+            string_view tipo = proximoToken(linha);
+            if (tipo == "N:")
+                lerInteiro(linha, cab.numNosRequeridos);
+            else if (tipo == "E:")
+                lerInteiro(linha, cab.numArestasRequeridas);
+            else if (tipo == "A:")
+                lerInteiro(linha, cab.numArcosRequeridos);
+        }
+        else if (chavePrimaria == "ReN." || chavePrimaria == "ReE." || chavePrimaria == "ReA.")
+            break; // Fim do cabeçalho
+    }
+    return cab;
+}
+
+// Faz o parsing de uma instância .dat já em memória (mesmo formato de lerGrafoDeArquivo), sem cópias:
+// as linhas e os tokens são visões sobre o buffer original. Os vetores do grafo são pré-alocados
+// com as contagens do cabeçalho. Também trata as seções de arestas (EDGE) e arcos (ARC) não requeridos.
+// Preenche dadosRetorno reaproveitando a capacidade já alocada nos seus vetores (memória do trabalhador no
+// modo em lote, ver InstanciaPreparada).
+void lerInstanciaDeMemoria(string_view texto, const string &nomeInstancia, DadosInstancia &dadosRetorno)
+{
+    dadosRetorno.idNoDeposito = -1;
+    dadosRetorno.capacidadeVeiculo = 0;
+    dadosRetorno.nomeInstancia = nomeInstancia;
+    dadosRetorno.g.inicializarGrafoInterno(0); // Descarta a instância anterior (um arquivo sem "#Nodes:" fica inválido)
+
+    enum class Secao
+    {
+        NENHUMA,
+        NOS_REQUERIDOS,
+        ARESTAS_REQUERIDAS,
+        ARESTAS_NAO_REQUERIDAS,
+        ARCOS_REQUERIDOS,
+        ARCOS_NAO_REQUERIDOS
+    };
+    Secao secao = Secao::NENHUMA;
+    CabecalhoInstancia cab;
+    Grafo &g = dadosRetorno.g;
+
+    string_view linha;
+    while (proximaLinha(texto, linha))
+    {
+        string_view resto = linha;
+        string_view chavePrimaria = proximoToken(resto);
+
+        // Dentro de uma seção de dados: uma linha vazia ou inválida encerra a seção
+        if (secao != Secao::NENHUMA)
+        {
+            if (chavePrimaria.empty())
+            {
+                secao = Secao::NENHUMA;
+                continue;
+            }
+            int origem, destino, tCusto, demanda, sCusto;
+            bool ok = true;
+            switch (secao)
+            {
+            case Secao::NOS_REQUERIDOS:
+            {
+                // "NX demanda s_custo": o ID do nó vem após o prefixo 'N'
+                int idNo;
+                auto [fimId, erroId] = from_chars(chavePrimaria.data() + 1, chavePrimaria.data() + chavePrimaria.size(), idNo);
+                ok = chavePrimaria[0] == 'N' && erroId == errc() && fimId == chavePrimaria.data() + chavePrimaria.size() &&
+                     lerInteiro(resto, demanda) && lerInteiro(resto, sCusto);
+                if (ok)
+                    g.adicionarVertice(idNo, demanda, sCusto);
+                break;
+            }
+            case Secao::ARESTAS_REQUERIDAS:
+                ok = chavePrimaria[0] == 'E' && lerInteiro(resto, origem) && lerInteiro(resto, destino) &&
+                     lerInteiro(resto, tCusto) && lerInteiro(resto, demanda) && lerInteiro(resto, sCusto);
+                if (ok)
+                    g.adicionarAresta(origem, destino, tCusto, demanda, sCusto);
+                break;
+            case Secao::ARCOS_REQUERIDOS:
+                ok = chavePrimaria[0] == 'A' && lerInteiro(resto, origem) && lerInteiro(resto, destino) &&
+                     lerInteiro(resto, tCusto) && lerInteiro(resto, demanda) && lerInteiro(resto, sCusto);
+                if (ok)
+                    g.adicionarArco(origem, destino, tCusto, demanda, sCusto);
+                break;
+            case Secao::ARESTAS_NAO_REQUERIDAS:
+                ok = lerInteiro(resto, origem) && lerInteiro(resto, destino) && lerInteiro(resto, tCusto);
+                if (ok)
+                    g.adicionarAresta(origem, destino, tCusto, 0, 0); // Demanda e s_custo são 0
+                break;
+            case Secao::ARCOS_NAO_REQUERIDOS:
+                ok = lerInteiro(resto, origem) && lerInteiro(resto, destino) && lerInteiro(resto, tCusto);
+                if (ok)
+                    g.adicionarArco(origem, destino, tCusto, 0, 0); // Demanda e s_custo são 0
+                break;
+            default:
+                break;
+            }
+            if (!ok)
+                secao = Secao::NENHUMA; // Fim da seção ou erro
+            continue;
+        }
+
+        // Processa o cabeçalho da instância
+        if (chavePrimaria == "Capacity:")
+        {
+            lerInteiro(resto, dadosRetorno.capacidadeVeiculo);
+        }
+        else if (chavePrimaria == "Depot" && proximoToken(resto) == "Node:")
+        {
+            lerInteiro(resto, dadosRetorno.idNoDeposito);
+        }
+        else if (chavePrimaria == "#Nodes:")
+        {
+            lerInteiro(resto, cab.numNos);
+            g.inicializarGrafoInterno(cab.numNos); // Inicializa o grafo com o número de nós lido
+        }
+        else if (chavePrimaria == "#Edges:")
+        {
+            lerInteiro(resto, cab.numArestas);
+        }
+        else if (chavePrimaria == "#Arcs:")
+        {
+            lerInteiro(resto, cab.numArcos);
+        }
+        else if (chavePrimaria == "#Required")
+        {
+            string_view tipo = proximoToken(resto);
+            if (tipo == "N:")
+                lerInteiro(resto, cab.numNosRequeridos);
+            else if (tipo == "E:")
+                lerInteiro(resto, cab.numArestasRequeridas);
+            else if (tipo == "A:")
+                lerInteiro(resto, cab.numArcosRequeridos);
+        }
+        // Início das seções de dados (a linha de títulos das colunas é descartada)
+        else if (chavePrimaria == "ReN.")
+        {
+            g.vertices.reserve(cab.numNosRequeridos);
+            secao = Secao::NOS_REQUERIDOS;
+        }
+        else if (chavePrimaria == "ReE.")
+        {
+            g.arestas.reserve(max(cab.numArestas, cab.numArestasRequeridas));
+            secao = Secao::ARESTAS_REQUERIDAS;
+        }
+        else if (chavePrimaria == "EDGE" || chavePrimaria == "EDGES")
+        {
+            g.arestas.reserve(cab.numArestas);
+            secao = Secao::ARESTAS_NAO_REQUERIDAS;
+        }
+        else if (chavePrimaria == "ReA.")
+        {
+            g.arcos.reserve(max(cab.numArcos, cab.numArcosRequeridos));
+            secao = Secao::ARCOS_REQUERIDOS;
+        }
+        else if (chavePrimaria == "ARC" || chavePrimaria == "ARCS")
+        {
+            g.arcos.reserve(cab.numArcos);
+            secao = Secao::ARCOS_NAO_REQUERIDOS;
+        }
+        // Demais chaves do cabeçalho (Name:, Optimal value:, #Vehicles:) não são usadas
+    }
+    g.congelar();
+}
+
+DadosInstancia lerInstanciaDeMemoria(string_view texto, const string &nomeInstancia)
+{
+    DadosInstancia dadosRetorno;
+    lerInstanciaDeMemoria(texto, nomeInstancia, dadosRetorno);
+    return dadosRetorno;
+}
+
+// Lê um arquivo de instância mapeando-o em memória e fazendo o parsing no próprio buffer.
+// Se estatisticas não for nulo, registra o tamanho lido e o tempo gasto.
+// Em caso de erro, dados fica com idNoDeposito = -1 e o motivo é escrito em erros.
+void lerGrafoMapeado(const string &nomeArquivo, DadosInstancia &dados, EstatisticasLeitura *estatisticas = nullptr,
+                     ostream &erros = cerr)
+{
+    auto inicio = chrono::steady_clock::now();
+    ArquivoMapeado arquivo(nomeArquivo);
+    if (!arquivo.estaAberto())
+    {
+        erros << "Erro ao abrir o arquivo: " << nomeArquivo << endl;
+        dados.g.inicializarGrafoInterno(0);
+        dados.idNoDeposito = -1;
+        dados.capacidadeVeiculo = 0;
+        dados.nomeInstancia = extrairNomeBaseInstancia(nomeArquivo);
+        return;
+    }
+    lerInstanciaDeMemoria(string_view(arquivo.dados(), arquivo.tamanho()), extrairNomeBaseInstancia(nomeArquivo), dados);
+    if (estatisticas)
+    {
+        estatisticas->bytes = arquivo.tamanho();
+        estatisticas->segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    }
+}
+
+DadosInstancia lerGrafoMapeado(const string &nomeArquivo, EstatisticasLeitura *estatisticas = nullptr)
+{
+    DadosInstancia dados;
+    lerGrafoMapeado(nomeArquivo, dados, estatisticas);
+    return dados;
+}
+
+#endif // LEITURA_RAPIDA_HPP
@@ -6,330 +6,370 @@
 #include <algorithm>
 #include <limits>
 #include <chrono>     // Para medição de tempo
-#include <filesystem> // Para C++17 ou posterior (iteração de diretório)
-
-namespace fs = std::filesystem;
-
-#include "grafo.hpp"   // Definições de Grafo, Servico, DadosInstancia, lerGrafoDeArquivo
-#include "funcoes.hpp" // Funções como floydWarshall, cálculo das métricas do grafo
+#include <thread>     // Etapas do pipeline do modo em lote
+#include <atomic>
+
+#include "grafo.hpp"              // Definições de Grafo, Servico, DadosInstancia, lerGrafoDeArquivo
+#include "leitura_rapida.hpp"     // Parsing com o arquivo mapeado em memória (lerGrafoMapeado)
+#include "fonte_instancias.hpp"   // Instâncias de uma pasta ou diretamente de um arquivo .zip
+#include "funcoes.hpp"            // Funções como floydWarshall, cálculo das métricas do grafo
+#include "oraculo_distancias.hpp" // Consulta de distâncias (matriz completa ou Dijkstra sob demanda)
+#include "nos_chave.hpp"          // Matriz compacta entre depósito e extremidades dos serviços
+#include "preparacao.hpp"         // Preparação da instância (processamento completo ou cache binário)
+#include "construtivo.hpp"        // Heurística construtiva gulosa
+#include "split.hpp"              // Construtivo por rota gigante + Split
+#include "busca_local.hpp"        // Busca local com avaliação de movimentos em O(1)
+#include "busca_local_iterada.hpp" // Busca local iterada com orçamento de tempo/iterações
+#include "grasp.hpp"              // Construções randomizadas em paralelo (GRASP)
+#include "solucao.hpp"            // Representação e escrita da solução
+#include "escrita_rapida.hpp"     // Buffer de escrita dos arquivos de saída
+#include "expansao_rotas.hpp"     // Sequência completa de nós das rotas (sob demanda)
+#include "opcoes.hpp"             // Leitura das opções de linha de comando
+#include "pool_threads.hpp"       // Filas limitadas do pipeline do modo em lote
 
 using namespace std;
 
-int main()
+// O modo em lote é um pipeline de três etapas ligadas por filas limitadas: uma thread de leitura faz o parsing
+// das próximas instâncias, os trabalhadores (--instancias) as resolvem e a thread principal grava as soluções.
+// Assim o parsing da próxima instância e a escrita da anterior acontecem enquanto a atual é resolvida. Cada
+// instância em trânsito ocupa uma InstanciaEmProcessamento, devolvida pela escrita para ser reaproveitada.
+struct InstanciaEmProcessamento
 {
-    // Caminho para a pasta contendo os arquivos de instância .dat
-    // !!! ATENÇÃO: Este caminho deve ser ajustado para o seu ambiente local !!!
-    string pastaInstancias = "C:\\Users\\lidio\\Downloads\\MCGRP";
-
-    vector<string> arquivosDat; // Para armazenar os caminhos dos arquivos .dat encontrados
-    try
+    int indice = -1;
+    bool valida = false;
+    InstanciaPreparada inst;
+    Solucao solucao;
+    long long microssegundosAlgoritmo = 0; // Tempo reportado (apenas a resolução)
+    long long microssegundosMelhor = 0;    // Tempo até a melhor solução
+};
+
+// Etapa de leitura: parsing da instância (ou carga do cache binário).
+// As mensagens vão para os fluxos saida/erros, para que o modo em lote possa imprimi-las em ordem.
+void lerEtapaInstancia(const FonteInstancias &fonte, const OpcoesExecucao &opcoes, InstanciaEmProcessamento &t,
+                       ostream &saida, ostream &erros)
+{
+    saida << "\nProcessando instancia: " << fonte.descricao(t.indice) << endl;
+    InstanciaPreparada &inst = t.inst;
+    t.valida = lerInstancia(fonte, t.indice, opcoes, inst, erros);
+    if (!t.valida)
     {
-        // Itera sobre os arquivos na pasta de instâncias
-        for (const auto &entry : fs::directory_iterator(pastaInstancias))
-        {
-            // Adiciona à lista se for um arquivo regular com extensão .dat
-            if (entry.is_regular_file() && entry.path().extension() == ".dat")
-            {
-                arquivosDat.push_back(entry.path().string());
-            }
-        }
+        return; // Em caso de erro, as demais etapas pulam a instância
     }
-    catch (const fs::filesystem_error &e)
+    if (inst.carregadaDoCache)
     {
-        cerr << "Erro ao acessar a pasta de instancias: " << pastaInstancias << " - " << e.what() << endl;
-        return 1; // Caso não consiga acessar a pasta, termina o programa
+        saida << "Instancia carregada do cache: " << inst.caminhoCache << endl;
     }
-
-    sort(arquivosDat.begin(), arquivosDat.end()); // Ordenamento dos arquivos (é opcional para consistência do código)
-
-    // Loop principal: processa cada arquivo de instância
-    for (const auto &caminhoCompletoInstancia : arquivosDat)
+    else if (inst.estatLeitura.bytes > 0)
     {
-        cout << "\nProcessando instancia: " << caminhoCompletoInstancia << endl;
-
-        // Inicia medição de tempo para o processamento desta instância
-        auto inicio_processamento_instancia = std::chrono::high_resolution_clock::now();
+        saida << "Leitura: " << inst.estatLeitura.bytes << " bytes em " << static_cast<long long>(inst.estatLeitura.segundos * 1e6)
+              << " microssegundos (" << inst.estatLeitura.mbPorSegundo() << " MB/s)" << endl;
+    }
+}
 
-        // 1. Leitura e parsing dos dados da instância
-        DadosInstancia dadosInst = lerGrafoDeArquivo(caminhoCompletoInstancia);
-        if (dadosInst.idNoDeposito == -1 || dadosInst.g.V == 0)
-        {
-            cerr << "Erro ao ler dados da instancia ou instancia invalida: " << dadosInst.nomeInstancia << endl;
-            continue; // Em caso de erro, pula para a próxima instância
-        }
+// Etapa de resolução: caminhos mínimos, heurística construtiva e melhoria (busca local, GRASP e ILS).
+// O tempo reportado cobre apenas esta etapa (não o parsing, a espera nas filas, a escrita da solução e do
+// cache nem o das métricas do grafo, que vão para linhaMetricas com --metricas).
+// reserva guarda os buffers da matriz completa do trabalhador, reaproveitados de uma instância para a próxima.
+void resolverInstancia(const OpcoesExecucao &opcoes, const ConfigFloydWarshall &configFW, ReservaMatrizes &reserva,
+                       InstanciaEmProcessamento &t, ostream &saida, ostream &erros, string &linhaMetricas)
+{
+    if (!t.valida)
+        return;
+    InstanciaPreparada &inst = t.inst;
 
-        // 2. Cálculo da matriz de caminhos mínimos entre todos os pares de nós
-        vector<vector<long long>> matDistancias = floydWarshall(dadosInst.g);
+    // Inicia medição de tempo para o processamento desta instância
+    auto inicio_processamento_instancia = std::chrono::high_resolution_clock::now();
 
-        // 3. Preparação da lista de todos os serviços requeridos (com demanda > 0)
-        vector<Servico> listaTodosServicos;
-        int idGlobalAtual = 1; // ID sequencial para cada serviço
+    // 1-4. Caminhos mínimos e matriz de nós-chave (a instância já foi lida ou carregada do cache)
+    if (!calcularDistanciasInstancia(opcoes, configFW, inst, erros, &reserva))
+    {
+        t.valida = false; // Nada a gravar para esta instância
+        return;
+    }
 
-        for (const auto &noReq : dadosInst.g.vertices)
+    // 5. Algoritmo construtivo para gerar as rotas (guloso ou rota gigante + Split)
+    Solucao &solucao = t.solucao;
+    solucao = opcoes.construtivo == ModoConstrutivo::SPLIT
+                          ? construirSolucaoSplit(inst, opcoes.tamanhoListaCandidatos, saida, erros)
+                          : construirSolucaoGulosa(inst, opcoes.tamanhoListaCandidatos, saida, erros);
+
+    // Instante em que a melhor solução foi obtida (linha "tempo para a melhor solução" do arquivo)
+    auto momento_melhor_solucao = std::chrono::high_resolution_clock::now();
+
+    // 6. Melhoria: busca local até um ótimo local, GRASP paralelo (com construções definidas) e, com orçamento
+    //    definido, busca local iterada (ILS), que sempre parte de um ótimo local.
+    //    Apenas se todas as rotas forem viáveis na matriz de distâncias.
+    ConfigBuscaLocal configBL = opcoes.configBuscaLocal;
+    if (opcoes.configMetaheuristica.ativa() && configBL.modo == ModoBuscaLocal::NENHUMA)
+        configBL.modo = ModoBuscaLocal::PRIMEIRA;
+    const bool usarGrasp = opcoes.configGrasp.construcoes > 0;
+    if ((configBL.modo != ModoBuscaLocal::NENHUMA || usarGrasp) && !solucao.rotas.empty())
+    {
+        bool rotasAlcancaveis = inst.chaveDeposito > 0;
+        for (Rota &r : solucao.rotas)
+            rotasAlcancaveis = rotasAlcancaveis && recalcularRota(r, inst.servicos, inst.distChaves, inst.chaveDeposito);
+        if (rotasAlcancaveis)
         {
-            if (noReq.demanda > 0)
+            if (configBL.modo != ModoBuscaLocal::NENHUMA)
             {
-                listaTodosServicos.push_back({idGlobalAtual++, Servico::Tipo::NO,
-                                              noReq.id, 0, 0,
-                                              noReq.demanda, noReq.s_custo, 0,
-                                              false,
-                                              noReq.id, noReq.id});
+                long long custoInicial = solucao.custoTotal;
+                BuscaLocal buscaLocal(inst.servicos, inst.distChaves, inst.chaveDeposito, inst.capacidadeVeiculo, configBL);
+                EstatisticasBuscaLocal estatBL = buscaLocal.otimizar(solucao);
+                momento_melhor_solucao = std::chrono::high_resolution_clock::now();
+                saida << "Busca local: custo " << custoInicial << " -> " << solucao.custoTotal << ", "
+                      << estatBL.movimentosAplicados << " movimentos aplicados, " << estatBL.movimentosAvaliados
+                      << " avaliados (" << static_cast<long long>(estatBL.movimentosPorSegundo()) << " por segundo)" << endl;
             }
-        }
-        for (const auto &arestaReq : dadosInst.g.arestas)
-        {
-            if (arestaReq.demanda > 0)
+
+            if (usarGrasp)
             {
-                listaTodosServicos.push_back({idGlobalAtual++, Servico::Tipo::ARESTA,
-                                              0, arestaReq.origem, arestaReq.destino,
-                                              arestaReq.demanda, arestaReq.s_custo, arestaReq.custo,
-                                              false,
-                                              0, 0});
+                Grasp grasp(inst.servicos, inst.distChaves, inst.chaveDeposito, inst.capacidadeVeiculo, configBL,
+                            opcoes.configGrasp);
+                ResultadoGrasp resultadoGrasp = grasp.executar(solucao);
+                saida << "GRASP: custo " << resultadoGrasp.custoInicial << " -> " << solucao.custoTotal << ", "
+                      << opcoes.configGrasp.construcoes << " construcoes em " << resultadoGrasp.numThreads << " threads";
+                if (resultadoGrasp.melhorConstrucao >= 0)
+                {
+                    momento_melhor_solucao = resultadoGrasp.momentoMelhor;
+                    saida << " (melhor: construcao " << resultadoGrasp.melhorConstrucao << ")";
+                }
+                saida << endl;
             }
-        }
-        for (const auto &arcoReq : dadosInst.g.arcos)
-        {
-            if (arcoReq.demanda > 0)
+
+            if (opcoes.configMetaheuristica.ativa())
             {
-                listaTodosServicos.push_back({idGlobalAtual++, Servico::Tipo::ARCO,
-                                              0, arcoReq.origem, arcoReq.destino,
-                                              arcoReq.demanda, arcoReq.s_custo, arcoReq.custo,
-                                              false,
-                                              arcoReq.origem, arcoReq.destino});
+                BuscaLocalIterada ils(inst.servicos, inst.distChaves, inst.chaveDeposito, inst.capacidadeVeiculo,
+                                      configBL, opcoes.configMetaheuristica);
+                ResultadoMetaheuristica resultadoILS = ils.executar(solucao);
+                if (resultadoILS.melhorias > 0)
+                    momento_melhor_solucao = resultadoILS.momentoMelhor;
+                saida << "ILS: custo " << resultadoILS.custoInicial << " -> " << solucao.custoTotal << ", "
+                      << resultadoILS.iteracoes << " iteracoes, " << resultadoILS.melhorias << " melhorias" << endl;
             }
         }
-
-        // 4. Algoritmo Construtivo Guloso para gerar as rotas
-        long long custoTotalSolucaoAlgoritmo = 0;
-        vector<string> stringsRotasSolucao;
-        int idProximaRotaValida = 1; // ID para a próxima rota válida a ser gerada
-        int servicosAtendidosCont = 0;
-        int totalServicosRequeridos = listaTodosServicos.size();
-
-        if (totalServicosRequeridos == 0)
-        {
-            cout << "Instancia " << dadosInst.nomeInstancia << " nao possui servicos requeridos." << endl;
-        }
         else
         {
-            int servicosAtendidosNaIteracaoAnterior; // Para salvaguarda contra loop infinito
-            // Loop principal de construção de rotas: continua enquanto houver serviços não atendidos
-            while (servicosAtendidosCont < totalServicosRequeridos)
-            {
-                servicosAtendidosNaIteracaoAnterior = servicosAtendidosCont;
-
-                // Inicializa uma nova rota
-                long long demandaRotaAtual = 0;
-                long long custoRotaAtual = 0;
-                vector<string> tuplasServicosRotaAtual;
-
-                tuplasServicosRotaAtual.push_back("(D 0,1,1)"); // Início da rota no depósito
-                int posAtualVeiculo = dadosInst.idNoDeposito;
-
-                bool podeAdicionarMaisServicosARota = true;
-                // Loop interno: adiciona serviços à rota atual enquanto possível
-                while (podeAdicionarMaisServicosARota)
-                {
-                    int melhorIndiceServicoParaAdicionar = -1;     // Índice do melhor serviço encontrado
-                    long long menorCustoParaServir = LONGLONG_INF; // Custo de avaliação do melhor serviço
-
-                    // Detalhes do melhor serviço candidato
-                    int p1CandidatoEscolhido = 0, p2CandidatoEscolhido = 0;
-                    int proxPosVeiculoAposServicoEscolhido = -1;
-
-                    // Itera sobre todos os serviços para encontrar o melhor para adicionar
-                    for (int i = 0; i < listaTodosServicos.size(); ++i)
-                    {
-                        // Considera o serviço se não foi atendido e cabe na capacidade
-                        if (!listaTodosServicos[i].atendido &&
-                            (demandaRotaAtual + listaTodosServicos[i].demanda <= dadosInst.capacidadeVeiculo))
-                        {
-
-                            const Servico &servicoCandidato = listaTodosServicos[i];
-                            long long custoTotalEsteServicoCandidato = LONGLONG_INF; // Custo de deslocamento + serviço
-                            int p1Temp = 0, p2Temp = 0, posFinalTemp = 0;            // Detalhes de como servir este candidato
+            saida << "Busca local ignorada para " << inst.nomeInstancia << ": rota com deslocamento impossivel." << endl;
+        }
+    }
 
-                            // Calcula o custo de servir e os pontos de passagem, dependendo do tipo de serviço
-                            if (servicoCandidato.tipo == Servico::Tipo::NO)
-                            {
-                                int noAServir = servicoCandidato.idNoOriginal;
-                                // Verifica validade dos nós e alcançabilidade
-                                if (noAServir > 0 && noAServir <= dadosInst.g.V &&
-                                    posAtualVeiculo > 0 && posAtualVeiculo <= dadosInst.g.V &&
-                                    matDistancias[posAtualVeiculo][noAServir] != LONGLONG_INF)
-                                {
-                                    custoTotalEsteServicoCandidato = matDistancias[posAtualVeiculo][noAServir] + servicoCandidato.custoServicoProprio;
-                                    p1Temp = noAServir;
-                                    p2Temp = noAServir;
-                                    posFinalTemp = noAServir;
-                                }
-                            }
-                            else if (servicoCandidato.tipo == Servico::Tipo::ARESTA)
-                            {
-                                int u = servicoCandidato.uOriginal;
-                                int v = servicoCandidato.vOriginal;
-                                long long custoViaU = LONGLONG_INF, custoViaV = LONGLONG_INF;
+    // Finaliza a medição de tempo e calcula a duração
+    auto fim_processamento_instancia = std::chrono::high_resolution_clock::now();
+    auto duracao_total_instancia = std::chrono::duration_cast<std::chrono::microseconds>(fim_processamento_instancia - inicio_processamento_instancia);
+    long long clocks_metricas = static_cast<long long>(inst.segundosMetricas * 1e6);
+    long long clocks_do_seu_algoritmo = duracao_total_instancia.count() - clocks_metricas; // Tempo em microssegundos
+    long long clocks_melhor_solucao = std::chrono::duration_cast<std::chrono::microseconds>(
+                                          momento_melhor_solucao - inicio_processamento_instancia)
+                                          .count() -
+                                      clocks_metricas;
+    if (inst.temMetricas)
+    {
+        ostringstream csv;
+        escreverLinhaMetricas(csv, inst.nomeInstancia, inst.metricas, true);
+        linhaMetricas = csv.str();
+        saida << "Metricas do grafo calculadas em " << clocks_metricas << " microssegundos." << endl;
+    }
 
-                                if (u > 0 && u <= dadosInst.g.V && v > 0 && v <= dadosInst.g.V &&
-                                    posAtualVeiculo > 0 && posAtualVeiculo <= dadosInst.g.V)
-                                {
-                                    // Opção 1: posAtual -> u -> v
-                                    if (matDistancias[posAtualVeiculo][u] != LONGLONG_INF)
-                                    {
-                                        custoViaU = matDistancias[posAtualVeiculo][u] + servicoCandidato.custoTravessia + servicoCandidato.custoServicoProprio;
-                                    }
-                                    // Opção 2: posAtual -> v -> u
-                                    if (matDistancias[posAtualVeiculo][v] != LONGLONG_INF)
-                                    {
-                                        custoViaV = matDistancias[posAtualVeiculo][v] + servicoCandidato.custoTravessia + servicoCandidato.custoServicoProprio;
-                                    }
+    saida << "Tempo de processamento para " << inst.nomeInstancia << ": " << clocks_do_seu_algoritmo << " microssegundos." << endl;
+    t.microssegundosAlgoritmo = clocks_do_seu_algoritmo;
+    t.microssegundosMelhor = clocks_melhor_solucao;
+}
 
-                                    // Escolhe a direção de serviço mais barata para a aresta
-                                    if (custoViaU <= custoViaV && custoViaU != LONGLONG_INF)
-                                    {
-                                        custoTotalEsteServicoCandidato = custoViaU;
-                                        p1Temp = u;
-                                        p2Temp = v;
-                                        posFinalTemp = v;
-                                    }
-                                    else if (custoViaV < custoViaU && custoViaV != LONGLONG_INF)
-                                    {
-                                        custoTotalEsteServicoCandidato = custoViaV;
-                                        p1Temp = v;
-                                        p2Temp = u;
-                                        posFinalTemp = u;
-                                    }
-                                }
-                            }
-                            else
-                            { // Tipo ARCO
-                                int u = servicoCandidato.uOriginal;
-                                int v = servicoCandidato.vOriginal;
-                                if (u > 0 && u <= dadosInst.g.V && v > 0 && v <= dadosInst.g.V &&
-                                    posAtualVeiculo > 0 && posAtualVeiculo <= dadosInst.g.V)
-                                {
-                                    if (matDistancias[posAtualVeiculo][u] != LONGLONG_INF)
-                                    { // Deslocamento até a origem do arco
-                                        custoTotalEsteServicoCandidato = matDistancias[posAtualVeiculo][u] + servicoCandidato.custoTravessia + servicoCandidato.custoServicoProprio;
-                                        p1Temp = u;
-                                        p2Temp = v;
-                                        posFinalTemp = v;
-                                    }
-                                }
-                            }
+// Etapa de escrita: arquivo da solução e, opcionalmente, a solução binária, as rotas expandidas e o cache da
+// instância (--cache). Os arquivos são montados no buffer da etapa, reaproveitado de uma instância para a próxima.
+void gravarInstancia(const OpcoesExecucao &opcoes, const InstanciaEmProcessamento &t, BufferSaida &buffer,
+                     ostream &saida, ostream &erros)
+{
+    if (!t.valida)
+        return;
+    const InstanciaPreparada &inst = t.inst;
+    const Solucao &solucao = t.solucao;
+
+    // 7. Geração do arquivo de saída da solução
+    string nomeArquivoSaida = "sol-" + inst.nomeInstancia + ".dat";
+    if (escreverSolucao(nomeArquivoSaida, solucao, inst.servicos, t.microssegundosAlgoritmo, t.microssegundosMelhor,
+                        buffer))
+    {
+        saida << "Solucao para " << inst.nomeInstancia << " salva em " << nomeArquivoSaida << endl;
+    }
+    else
+    {
+        erros << "Erro ao abrir arquivo de saida: " << nomeArquivoSaida << endl;
+    }
+    if (opcoes.solucaoBinaria)
+    {
+        string nomeArquivoBinario = "sol-" + inst.nomeInstancia + ".bin";
+        if (!escreverSolucaoBinaria(nomeArquivoBinario, solucao, inst.servicos, t.microssegundosAlgoritmo,
+                                    t.microssegundosMelhor, buffer))
+        {
+            erros << "Erro ao abrir arquivo de saida: " << nomeArquivoBinario << endl;
+        }
+    }
 
-                            // Se este candidato for o melhor até agora, armazena seus detalhes
-                            if (custoTotalEsteServicoCandidato < menorCustoParaServir)
-                            {
-                                menorCustoParaServir = custoTotalEsteServicoCandidato;
-                                melhorIndiceServicoParaAdicionar = i;
-                                p1CandidatoEscolhido = p1Temp;
-                                p2CandidatoEscolhido = p2Temp;
-                                proxPosVeiculoAposServicoEscolhido = posFinalTemp;
-                            }
-                        }
-                    }
+    // Cache da instância para as próximas execuções (fora do tempo reportado)
+    gravarCacheInstanciaPreparada(inst, erros);
 
-                    // Se um serviço viável foi encontrado, adiciona-o à rota
-                    if (melhorIndiceServicoParaAdicionar != -1)
-                    {
-                        Servico &servEscolhido = listaTodosServicos[melhorIndiceServicoParaAdicionar];
-                        servEscolhido.atendido = true;
-                        servEscolhido.p1Saida = p1CandidatoEscolhido;
-                        servEscolhido.p2Saida = p2CandidatoEscolhido;
-                        servicosAtendidosCont++;
+    // 8. Rotas expandidas em nós do grafo (opcional, fora do tempo reportado)
+    if (opcoes.rotasExpandidas && inst.chaveDeposito > 0)
+    {
+        Grafo grafoDoCache;
+        if (inst.carregadaDoCache)
+            grafoDoCache = inst.cache.reconstruirGrafo();
+        const Grafo &g = inst.carregadaDoCache ? grafoDoCache : inst.dados.g;
+        ExpansorRotas expansor(g, inst.noDaChave, static_cast<int>(inst.distChaves.numVertices()));
+        string nomeArquivoRotas = "rotas-" + inst.nomeInstancia + ".dat";
+        if (escreverRotasExpandidas(nomeArquivoRotas, solucao, inst.servicos, inst.chaveDeposito, expansor, buffer))
+        {
+            saida << "Rotas expandidas para " << inst.nomeInstancia << " salvas em " << nomeArquivoRotas << " ("
+                  << expansor.arvoresCalculadas() << " arvores de caminhos minimos)" << endl;
+        }
+        else
+        {
+            erros << "Erro ao abrir arquivo de saida: " << nomeArquivoRotas << endl;
+        }
+    }
+}
 
-                        demandaRotaAtual += servEscolhido.demanda;
-                        custoRotaAtual += menorCustoParaServir; // Adiciona custo total (deslocamento + serviço)
+// Estimativa do custo de processamento de uma instância a partir do cabeçalho:
+// O(V^3) do cálculo de caminhos mínimos mais O(S^2) da heurística construtiva.
+double estimarCustoInstancia(const CabecalhoInstancia &cab)
+{
+    double V = cab.numNos, S = cab.numServicos();
+    return V * V * V + S * S;
+}
 
-                        tuplasServicosRotaAtual.push_back("(S " + std::to_string(servEscolhido.idGlobal) + "," +
-                                                          std::to_string(servEscolhido.p1Saida) + "," +
-                                                          std::to_string(servEscolhido.p2Saida) + ")");
-                        posAtualVeiculo = proxPosVeiculoAposServicoEscolhido; // Atualiza posição do veículo
-                    }
-                    else
-                    {
-                        // Nenhum serviço pode ser adicionado (capacidade, todos atendidos, inalcançável)
-                        podeAdicionarMaisServicosARota = false;
-                    }
-                } // Fim do loop de adicionar serviços à rota atual
+int main(int argc, char *argv[])
+{
+    OpcoesExecucao opcoes;
+    if (!lerOpcoes(argc, argv, opcoes))
+    {
+        return 1;
+    }
+    // Pasta com os arquivos .dat ou arquivo .zip com as instâncias
+    unique_ptr<FonteInstancias> fonte = abrirFonteInstancias(opcoes.pastaInstancias, opcoes.leituraMapeada, cerr);
+    if (!fonte)
+    {
+        return 1; // Caso não consiga acessar as instâncias, termina o programa
+    }
+    if (!opcoes.pastaCache.empty())
+    {
+        error_code ec;
+        std::filesystem::create_directories(opcoes.pastaCache, ec);
+        if (ec)
+        {
+            cerr << "Erro ao criar a pasta de cache: " << opcoes.pastaCache << " - " << ec.message() << endl;
+            return 1;
+        }
+    }
 
-                // Finaliza a rota: calcula custo de retorno ao depósito
-                if (posAtualVeiculo != dadosInst.idNoDeposito &&
-                    (posAtualVeiculo > 0 && posAtualVeiculo <= dadosInst.g.V &&
-                     dadosInst.idNoDeposito > 0 && dadosInst.idNoDeposito <= dadosInst.g.V &&
-                     matDistancias[posAtualVeiculo][dadosInst.idNoDeposito] != LONGLONG_INF))
-                {
-                    custoRotaAtual += matDistancias[posAtualVeiculo][dadosInst.idNoDeposito];
-                }
-                else if (posAtualVeiculo != dadosInst.idNoDeposito)
-                {
-                    cerr << "ALERTA: Rota (ID proximo: " << idProximaRotaValida << ") para " << dadosInst.nomeInstancia
-                         << " nao pode retornar ao deposito do no " << posAtualVeiculo << "." << endl;
-                }
-                tuplasServicosRotaAtual.push_back("(D 0,1,1)"); // Fim da rota no depósito
+    // Processa as instâncias no pipeline leitura -> resolução -> escrita, com um ou mais trabalhadores na
+    // resolução (maiores primeiro quando há vários). As mensagens de cada instância são impressas na ordem dos
+    // arquivos, assim que a solução é gravada.
+    const int numArquivos = fonte->quantidade();
+    const int numTrabalhadores = max(1, min(resolverNumThreads(opcoes.instanciasParalelas), numArquivos));
 
-                // Armazena a rota na solução se ela atendeu pelo menos um serviço
-                if (tuplasServicosRotaAtual.size() > 2)
-                {
-                    custoTotalSolucaoAlgoritmo += custoRotaAtual;
-                    string strRota = "0 1 " + std::to_string(idProximaRotaValida) + " " +
-                                     std::to_string(demandaRotaAtual) + " " +
-                                     std::to_string(custoRotaAtual) + " " +
-                                     std::to_string(tuplasServicosRotaAtual.size());
-                    for (const auto &tupla : tuplasServicosRotaAtual)
-                    {
-                        strRota += " " + tupla;
-                    }
-                    stringsRotasSolucao.push_back(strRota);
-                    idProximaRotaValida++; // Incrementa ID para a próxima rota válida
-                }
+    // Com várias instâncias simultâneas, o Floyd-Warshall e o GRASP de cada uma dividem os núcleos
+    ConfigFloydWarshall configFWInstancia = opcoes.configFW;
+    if (numTrabalhadores > 1 && configFWInstancia.numThreads == 0)
+    {
+        configFWInstancia.numThreads = max(1, resolverNumThreads(0) / numTrabalhadores);
+    }
+    OpcoesExecucao opcoesInstancia = opcoes;
+    if (numTrabalhadores > 1 && opcoesInstancia.configGrasp.numThreads == 0)
+    {
+        opcoesInstancia.configGrasp.numThreads = max(1, resolverNumThreads(0) / numTrabalhadores);
+    }
 
-                // Salvaguarda: se nenhum serviço foi adicionado nesta iteração e ainda há serviços pendentes, para.
-                if (servicosAtendidosCont == servicosAtendidosNaIteracaoAnterior && servicosAtendidosCont < totalServicosRequeridos)
-                {
-                    cout << "Alerta: Nenhum servico adicional pode ser atendido para " << dadosInst.nomeInstancia
-                         << ". Servicos atendidos: " << servicosAtendidosCont << "/" << totalServicosRequeridos
-                         << ". Parando." << endl;
-                    break; // Sai do loop 'while (servicosAtendidosCont < totalServicosRequeridos)'
-                }
-            } // Fim do loop principal de construção de rotas
-        }
+    vector<int> ordem(numArquivos);
+    for (int i = 0; i < numArquivos; i++)
+        ordem[i] = i;
+    if (numTrabalhadores > 1)
+    {
+        vector<double> custoEstimado(numArquivos);
+        for (int i = 0; i < numArquivos; i++)
+            custoEstimado[i] = estimarCustoInstancia(fonte->lerCabecalho(i));
+        stable_sort(ordem.begin(), ordem.end(), [&](int a, int b)
+                    { return custoEstimado[a] > custoEstimado[b]; });
+    }
 
-        // Mensagem final se nem todos os serviços foram atendidos
-        if (servicosAtendidosCont < totalServicosRequeridos && totalServicosRequeridos > 0)
+    vector<ostringstream> saidas(numArquivos), erros(numArquivos);
+    vector<string> linhasMetricas(numArquivos);
+    vector<char> concluida(numArquivos, 0);
+    int proximaAImprimir = 0;
+
+    // Filas entre as etapas (a capacidade limita quantas instâncias ficam lidas à frente ou aguardando escrita)
+    // e áreas suficientes para que nenhuma etapa espere por uma área livre.
+    const int profundidade = opcoes.profundidadeFila;
+    vector<InstanciaEmProcessamento> areas(numTrabalhadores + 2 * profundidade + 2);
+    FilaLimitada<InstanciaEmProcessamento *> livres(areas.size()), lidas(profundidade), resolvidas(profundidade);
+    for (InstanciaEmProcessamento &a : areas)
+        livres.inserir(&a);
+
+    thread leitor([&]
+                  {
+        for (int i : ordem)
         {
-            cout << "Alerta Final: Para " << dadosInst.nomeInstancia << ", nem todos os servicos foram atendidos. "
-                 << "Atendidos: " << servicosAtendidosCont << "/" << totalServicosRequeridos << endl;
+            InstanciaEmProcessamento *t = nullptr;
+            if (!livres.retirar(t))
+                break;
+            t->indice = i;
+            lerEtapaInstancia(*fonte, opcoesInstancia, *t, saidas[i], erros[i]);
+            lidas.inserir(t);
         }
+        lidas.fechar(); });
 
-        // Finaliza a medição de tempo e calcula a duração
-        auto fim_processamento_instancia = std::chrono::high_resolution_clock::now();
-        auto duracao_total_instancia = std::chrono::duration_cast<std::chrono::microseconds>(fim_processamento_instancia - inicio_processamento_instancia);
-        long long clocks_do_seu_algoritmo = duracao_total_instancia.count(); // Tempo em microssegundos
-
-        cout << "Tempo de processamento para " << dadosInst.nomeInstancia << ": " << clocks_do_seu_algoritmo << " microssegundos." << endl;
-
-        // 5. Geração do arquivo de saída da solução
-        string nomeArquivoSaida = "sol-" + dadosInst.nomeInstancia + ".dat";
-        ofstream arqSaida(nomeArquivoSaida);
-        if (arqSaida.is_open())
-        {
-            arqSaida << custoTotalSolucaoAlgoritmo << endl;
-            arqSaida << stringsRotasSolucao.size() << endl;
-            arqSaida << clocks_do_seu_algoritmo << endl; // Clocks do seu algoritmo
-            arqSaida << clocks_do_seu_algoritmo << endl; // Clocks do seu algoritmo (tempo para melhor solução é o mesmo na Etapa 2)
-            for (const auto &r_str : stringsRotasSolucao)
+    vector<ReservaMatrizes> reservas(numTrabalhadores); // Matriz completa de cada trabalhador, reaproveitada
+    atomic<int> trabalhadoresAtivos(numTrabalhadores);
+    vector<thread> trabalhadores;
+    for (int w = 0; w < numTrabalhadores; ++w)
+    {
+        trabalhadores.emplace_back([&, w]
+                                   {
+            InstanciaEmProcessamento *t = nullptr;
+            while (lidas.retirar(t))
             {
-                arqSaida << r_str << endl;
+                const int i = t->indice;
+                resolverInstancia(opcoesInstancia, configFWInstancia, reservas[w], *t, saidas[i], erros[i],
+                                  linhasMetricas[i]);
+                resolvidas.inserir(t);
             }
-            arqSaida.close();
-            cout << "Solucao para " << dadosInst.nomeInstancia << " salva em " << nomeArquivoSaida << endl;
+            if (--trabalhadoresAtivos == 0)
+                resolvidas.fechar(); });
+    }
+
+    // Etapa de escrita na thread principal
+    BufferSaida bufferEscrita;
+    InstanciaEmProcessamento *t = nullptr;
+    while (resolvidas.retirar(t))
+    {
+        gravarInstancia(opcoesInstancia, *t, bufferEscrita, saidas[t->indice], erros[t->indice]);
+        concluida[t->indice] = 1;
+        livres.inserir(t);
+        while (proximaAImprimir < numArquivos && concluida[proximaAImprimir])
+        {
+            cout << saidas[proximaAImprimir].str() << flush;
+            cerr << erros[proximaAImprimir].str() << flush;
+            saidas[proximaAImprimir] = ostringstream();
+            erros[proximaAImprimir] = ostringstream();
+            proximaAImprimir++;
         }
-        else
+    }
+    leitor.join();
+    for (thread &th : trabalhadores)
+        th.join();
+
+    // Métricas do grafo na ordem dos arquivos
+    if (!opcoes.arquivoMetricas.empty())
+    {
+        ofstream csv(opcoes.arquivoMetricas);
+        if (!csv)
         {
-            cerr << "Erro ao abrir arquivo de saida: " << nomeArquivoSaida << endl;
+            cerr << "Erro ao criar o arquivo de metricas: " << opcoes.arquivoMetricas << endl;
+            return 1;
         }
-    } // Fim do loop de processamento de instâncias
+        escreverCabecalhoMetricas(csv);
+        for (const string &linha : linhasMetricas)
+            csv << linha;
+    }
     return 0;
 }
@@ -0,0 +1,320 @@
+#ifndef MATRIZ_DISTANCIAS_HPP
+#define MATRIZ_DISTANCIAS_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "pool_threads.hpp" // Pool de threads para o modo paralelo
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h> // Intrínsecos SIMD para o núcleo de relaxação
+#endif
+
+using namespace std;
+
+// Define um valor grande para representar "infinito" em distâncias do tipo long long.
+const long long LONGLONG_INF = numeric_limits<long long>::max();
+
+// Sentinela "infinito" armazenado internamente na matriz de distâncias.
+// É pequeno o suficiente para que a soma de dois sentinelas não cause overflow,
+// o que permite relaxar d[i][j] = min(d[i][j], d[i][k] + d[k][j]) sem desvios.
+const long long DIST_INF_SATURADO = numeric_limits<long long>::max() / 4;
+
+// Sentinela equivalente para matrizes de 32 bits: a soma de dois sentinelas ainda cabe em int32_t.
+const int32_t DIST_INF_SATURADO_32 = numeric_limits<int32_t>::max() / 2;
+
+// Sentinela "infinito" do tipo de custo armazenado na matriz (long long ou int32_t).
+template <typename Custo>
+constexpr Custo infSaturado();
+template <>
+constexpr long long infSaturado<long long>() { return DIST_INF_SATURADO; }
+template <>
+constexpr int32_t infSaturado<int32_t>() { return DIST_INF_SATURADO_32; }
+
+// Tamanho (em nós) dos blocos quadrados usados pelo Floyd-Warshall particionado.
+// Três blocos de 64x64 long long ocupam 96 KB, o que cabe na cache L2.
+const int TAMANHO_BLOCO_FW = 64;
+
+// Número mínimo de nós para que o Floyd-Warshall use o modo paralelo.
+// Abaixo disso o custo de sincronizar as threads supera o ganho.
+const int LIMIAR_FW_PARALELO = 512;
+
+// Parâmetros do cálculo de caminhos mínimos entre todos os pares.
+struct ConfigFloydWarshall
+{
+    int numThreads = 0;                      // Threads do modo paralelo (0 = número de núcleos)
+    int limiarParalelo = LIMIAR_FW_PARALELO; // Abaixo deste número de nós usa o caminho serial
+    int tamanhoBloco = TAMANHO_BLOCO_FW;     // Lado dos blocos do núcleo particionado
+};
+
+// Alocador que garante o alinhamento dos dados (ex.: 64 bytes = uma linha de cache).
+template <typename T, size_t Alinhamento>
+struct AlocadorAlinhado
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AlocadorAlinhado<U, Alinhamento>;
+    };
+
+    AlocadorAlinhado() = default;
+    template <typename U>
+    AlocadorAlinhado(const AlocadorAlinhado<U, Alinhamento> &) {}
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alinhamento)));
+    }
+    void deallocate(T *p, size_t)
+    {
+        ::operator delete(p, std::align_val_t(Alinhamento));
+    }
+
+    template <typename U>
+    bool operator==(const AlocadorAlinhado<U, Alinhamento> &) const { return true; }
+    template <typename U>
+    bool operator!=(const AlocadorAlinhado<U, Alinhamento> &) const { return false; }
+};
+
+// Visão somente leitura sobre uma matriz de distâncias armazenada em outro lugar
+// (uma MatrizDistancias ou um arquivo de cache mapeado em memória), com o mesmo layout.
+struct VisaoMatrizDistancias
+{
+    const long long *dados = nullptr;
+    size_t passoLinha = 0;
+    int n = 0;
+
+    int numVertices() const { return n; }
+    size_t passo() const { return passoLinha; }
+
+    long long operator()(int i, int j) const
+    {
+        long long d = dados[i * passoLinha + j];
+        return d >= DIST_INF_SATURADO ? LONGLONG_INF : d;
+    }
+
+    const long long *linha(int i) const { return dados + i * passoLinha; }
+};
+
+// Matriz de distâncias (V+1)x(V+1) armazenada em um único buffer contíguo e alinhado.
+// Mantém a indexação baseada em 1 do restante do projeto (linha/coluna 0 não usadas).
+// Cada linha é preenchida até um múltiplo de 64 bytes para começar alinhada.
+// Custo é o tipo armazenado: long long (padrão) ou int32_t, que ocupa metade da memória e dobra o número
+// de elementos por registrador SIMD quando todas as distâncias cabem em 32 bits (ver custosCabemEm32Bits).
+template <typename Custo>
+class MatrizDistanciasT
+{
+public:
+    MatrizDistanciasT(int num_vertices = 0) { redimensionar(num_vertices); }
+
+    // (Re)dimensiona a matriz para num_vertices nós, preenchendo tudo com "infinito".
+    void redimensionar(int num_vertices)
+    {
+        const size_t porLinhaCache = 64 / sizeof(Custo);
+        n = num_vertices;
+        passoLinha = ((static_cast<size_t>(n) + 1 + porLinhaCache - 1) / porLinhaCache) * porLinhaCache;
+        dados.assign(passoLinha * (n + 1), infSaturado<Custo>());
+    }
+
+    int numVertices() const { return n; }
+    size_t passo() const { return passoLinha; }
+
+    // Acesso de leitura compatível com a matriz antiga: caminhos inexistentes retornam LONGLONG_INF.
+    long long operator()(int i, int j) const
+    {
+        Custo d = dados[i * passoLinha + j];
+        return d >= infSaturado<Custo>() ? LONGLONG_INF : static_cast<long long>(d);
+    }
+
+    // Acesso direto ao valor armazenado (com o sentinela infSaturado<Custo>()), usado pelos núcleos.
+    Custo &bruto(int i, int j) { return dados[i * passoLinha + j]; }
+    Custo bruto(int i, int j) const { return dados[i * passoLinha + j]; }
+
+    // Ponteiro para o início da linha i (alinhado a 64 bytes).
+    Custo *linha(int i) { return dados.data() + i * passoLinha; }
+    const Custo *linha(int i) const { return dados.data() + i * passoLinha; }
+
+    // Visão de 64 bits (só existe para Custo = long long).
+    VisaoMatrizDistancias visao() const { return {dados.data(), passoLinha, n}; }
+
+    // Buffer completo ((V+1) x passo() elementos), usado para gravar a matriz em disco.
+    const Custo *dadosBrutos() const { return dados.data(); }
+
+private:
+    int n = 0;
+    size_t passoLinha = 0;
+    vector<Custo, AlocadorAlinhado<Custo, 64>> dados;
+};
+
+// Matriz de 64 bits usada pelo restante do projeto (nós-chave, cache, Etapa 1).
+using MatrizDistancias = MatrizDistanciasT<long long>;
+
+// Relaxa uma faixa de linha: dst[j] = min(dst[j], dik + src[j]) para j em [0, tam).
+// Sem desvios no laço interno; usa AVX2 ou SSE4.2 quando disponíveis e um laço escalar no restante.
+inline void relaxarLinha(long long *__restrict dst, const long long *__restrict src, long long dik, int tam)
+{
+    int j = 0;
+#if defined(__AVX2__)
+    const __m256i vDik = _mm256_set1_epi64x(dik);
+    for (; j + 4 <= tam; j += 4)
+    {
+        __m256i atual = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + j));
+        __m256i viaK = _mm256_add_epi64(vDik, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + j)));
+        __m256i melhora = _mm256_cmpgt_epi64(atual, viaK);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + j), _mm256_blendv_epi8(atual, viaK, melhora));
+    }
+#elif defined(__SSE4_2__)
+    const __m128i vDik = _mm_set1_epi64x(dik);
+    for (; j + 2 <= tam; j += 2)
+    {
+        __m128i atual = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + j));
+        __m128i viaK = _mm_add_epi64(vDik, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + j)));
+        __m128i melhora = _mm_cmpgt_epi64(atual, viaK);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + j), _mm_blendv_epi8(atual, viaK, melhora));
+    }
+#endif
+    for (; j < tam; ++j)
+    {
+        long long viaK = dik + src[j];
+        dst[j] = viaK < dst[j] ? viaK : dst[j];
+    }
+}
+
+// Mesma relaxação para a matriz de 32 bits: oito elementos por vez com AVX2 (quatro com SSE4.2).
+inline void relaxarLinha(int32_t *__restrict dst, const int32_t *__restrict src, int32_t dik, int tam)
+{
+    int j = 0;
+#if defined(__AVX2__)
+    const __m256i vDik = _mm256_set1_epi32(dik);
+    for (; j + 8 <= tam; j += 8)
+    {
+        __m256i viaK = _mm256_add_epi32(vDik, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + j)));
+        __m256i atual = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + j), _mm256_min_epi32(atual, viaK));
+    }
+#elif defined(__SSE4_2__)
+    const __m128i vDik = _mm_set1_epi32(dik);
+    for (; j + 4 <= tam; j += 4)
+    {
+        __m128i viaK = _mm_add_epi32(vDik, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + j)));
+        __m128i atual = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + j));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + j), _mm_min_epi32(atual, viaK));
+    }
+#endif
+    for (; j < tam; ++j)
+    {
+        int32_t viaK = dik + src[j];
+        dst[j] = viaK < dst[j] ? viaK : dst[j];
+    }
+}
+
+// Relaxa o bloco de destino [i0,i1) x [j0,j1) usando os nós intermediários k em [k0,k1).
+template <typename Custo>
+void relaxarBlocoFW(MatrizDistanciasT<Custo> &dist, int k0, int k1, int i0, int i1, int j0, int j1)
+{
+    for (int k = k0; k < k1; ++k)
+    {
+        const Custo *linhaK = dist.linha(k) + j0;
+        for (int i = i0; i < i1; ++i)
+        {
+            if (i == k)
+                continue; // d[k][k] = 0: a linha k não muda com k como intermediário
+            Custo dik = dist.bruto(i, k);
+            if (dik >= infSaturado<Custo>())
+                continue; // Sem caminho i->k, nada a relaxar nesta linha
+            relaxarLinha(dist.linha(i) + j0, linhaK, dik, j1 - j0);
+        }
+    }
+}
+
+// Floyd-Warshall particionado em blocos (nós 1..n) sobre uma matriz já inicializada.
+// Para cada bloco diagonal: (1) o próprio bloco, (2) os painéis de sua linha e coluna,
+// (3) os blocos restantes. O resultado é idêntico ao do laço triplo ingênuo.
+template <typename Custo>
+void floydWarshallBlocado(MatrizDistanciasT<Custo> &dist, int tamBloco = TAMANHO_BLOCO_FW)
+{
+    const int inicio = 1, fim = dist.numVertices() + 1;
+    for (int kb = inicio; kb < fim; kb += tamBloco)
+    {
+        const int kbFim = min(kb + tamBloco, fim);
+
+        // Fase 1: bloco diagonal
+        relaxarBlocoFW(dist, kb, kbFim, kb, kbFim, kb, kbFim);
+
+        // Fase 2: painéis da linha e da coluna do bloco diagonal
+        for (int b = inicio; b < fim; b += tamBloco)
+        {
+            if (b == kb)
+                continue;
+            const int bFim = min(b + tamBloco, fim);
+            relaxarBlocoFW(dist, kb, kbFim, kb, kbFim, b, bFim); // Painel da linha
+            relaxarBlocoFW(dist, kb, kbFim, b, bFim, kb, kbFim); // Painel da coluna
+        }
+
+        // Fase 3: blocos restantes
+        for (int ib = inicio; ib < fim; ib += tamBloco)
+        {
+            if (ib == kb)
+                continue;
+            const int ibFim = min(ib + tamBloco, fim);
+            for (int jb = inicio; jb < fim; jb += tamBloco)
+            {
+                if (jb == kb)
+                    continue;
+                relaxarBlocoFW(dist, kb, kbFim, ib, ibFim, jb, min(jb + tamBloco, fim));
+            }
+        }
+    }
+}
+
+// Versão paralela do Floyd-Warshall particionado. As três fases são as mesmas da versão serial;
+// dentro de cada fase os blocos são independentes entre si e são distribuídos no pool.
+template <typename Custo>
+void floydWarshallBlocadoParalelo(MatrizDistanciasT<Custo> &dist, PoolThreads &pool, int tamBloco = TAMANHO_BLOCO_FW)
+{
+    const int inicio = 1, fim = dist.numVertices() + 1;
+    const int numBlocos = (fim - inicio + tamBloco - 1) / tamBloco;
+    auto inicioBloco = [&](int b)
+    { return inicio + b * tamBloco; };
+    auto fimBloco = [&](int b)
+    { return min(inicio + (b + 1) * tamBloco, fim); };
+
+    for (int kb = 0; kb < numBlocos; ++kb)
+    {
+        const int k0 = inicioBloco(kb), k1 = fimBloco(kb);
+
+        // Fase 1: bloco diagonal (serial, todas as outras fases dependem dele)
+        relaxarBlocoFW(dist, k0, k1, k0, k1, k0, k1);
+
+        // Fase 2: painéis da linha (tarefas pares) e da coluna (tarefas ímpares)
+        pool.executarParalelo(2 * numBlocos, [&](int tarefa)
+                              {
+            int b = tarefa / 2;
+            if (b == kb)
+                return;
+            if (tarefa % 2 == 0)
+                relaxarBlocoFW(dist, k0, k1, k0, k1, inicioBloco(b), fimBloco(b));
+            else
+                relaxarBlocoFW(dist, k0, k1, inicioBloco(b), fimBloco(b), k0, k1); });
+
+        // Fase 3: blocos restantes; cada tarefa é uma faixa de linhas de blocos
+        pool.executarParalelo(numBlocos, [&](int ib)
+                              {
+            if (ib == kb)
+                return;
+            for (int jb = 0; jb < numBlocos; ++jb)
+            {
+                if (jb == kb)
+                    continue;
+                relaxarBlocoFW(dist, k0, k1, inicioBloco(ib), fimBloco(ib), inicioBloco(jb), fimBloco(jb));
+            } });
+    }
+}
+
+#endif // MATRIZ_DISTANCIAS_HPP
@@ -0,0 +1,155 @@
+#ifndef METRICAS_HPP
+#define METRICAS_HPP
+
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <limits>
+
+#include "grafo.hpp"             // Grafo
+#include "matriz_distancias.hpp" // VisaoMatrizDistancias, DIST_INF_SATURADO, LONGLONG_INF
+#include "intermediacao.hpp"     // calcularIntermediacaoBrandes
+
+using namespace std;
+
+// Métricas do grafo (Etapa 1) calculadas a partir de distâncias já disponíveis: a matriz do Floyd-Warshall
+// ou as linhas de qualquer oráculo de distâncias, para que o relatório reaproveite o mesmo cálculo de
+// caminhos mínimos usado pelo construtivo. Diâmetro, caminho médio e alcançabilidade saem de uma única
+// passada pelas linhas, sem desvios no laço interno (vetorizável); graus e contagens vêm das listas do grafo
+// e a intermediação do motor de Brandes.
+
+struct MetricasGrafo
+{
+    int verticesRequeridos = 0;
+    int arestasRequeridas = 0;
+    int arcosRequeridos = 0;
+    double densidade = 0;
+    int grauMinimo = 0;
+    int grauMaximo = 0;
+    double grauMedio = 0;
+    long long diametro = 0;        // LONGLONG_INF se algum par não for alcançável
+    double caminhoMedio = 0;       // Média das distâncias finitas entre os pares i < j
+    double alcancabilidade = 0;    // Fração dos pares ordenados (i, j), i != j, com caminho
+    float intermediacao = 0;
+};
+
+// Acumula diâmetro, caminho médio e alcançabilidade linha a linha (índices 1..V, valores brutos).
+class AcumuladorDistancias
+{
+public:
+    explicit AcumuladorDistancias(int n_) : n(n_) {}
+
+    void acumularLinha(int i, const long long *linha)
+    {
+        long long maximo = 0, alcancaveis = 0;
+        // j < i: apenas diâmetro e alcançabilidade
+        for (int j = 1; j < i; ++j)
+        {
+            const long long d = linha[j];
+            const bool finito = d < DIST_INF_SATURADO;
+            maximo = max(maximo, finito ? d : 0);
+            alcancaveis += finito;
+        }
+        // j > i: também os pares do caminho médio
+        long long soma = 0, alcancaveisSuperior = 0;
+        for (int j = i + 1; j <= n; ++j)
+        {
+            const long long d = linha[j];
+            const bool finito = d < DIST_INF_SATURADO;
+            maximo = max(maximo, finito ? d : 0);
+            soma += finito ? d : 0;
+            alcancaveisSuperior += finito;
+        }
+        maiorDistancia = max(maiorDistancia, maximo);
+        paresAlcancaveis += alcancaveis + alcancaveisSuperior;
+        somaSuperior += soma;
+        paresSuperior += alcancaveisSuperior;
+    }
+
+    void finalizar(MetricasGrafo &m) const
+    {
+        const long long pares = static_cast<long long>(n) * (n - 1);
+        m.diametro = n < 2 ? 0 : (paresAlcancaveis < pares ? LONGLONG_INF : maiorDistancia);
+        m.caminhoMedio = paresSuperior > 0 ? static_cast<double>(somaSuperior) / paresSuperior : 0.0;
+        m.alcancabilidade = pares > 0 ? static_cast<double>(paresAlcancaveis) / pares : 0.0;
+    }
+
+private:
+    int n;
+    long long maiorDistancia = 0;
+    long long paresAlcancaveis = 0;
+    long long somaSuperior = 0;
+    long long paresSuperior = 0;
+};
+
+// Métricas que dependem apenas do grafo (contagens, densidade, graus e intermediação).
+void calcularMetricasEstruturais(const Grafo &g, MetricasGrafo &m, int numThreads)
+{
+    for (const auto &v : g.vertices)
+        m.verticesRequeridos += v.demanda > 0;
+    for (const auto &a : g.arestas)
+        m.arestasRequeridas += a.demanda > 0;
+    for (const auto &a : g.arcos)
+        m.arcosRequeridos += a.demanda > 0;
+    m.densidade = g.V < 2 ? 0.0 : (2.0 * g.arestas.size()) / (static_cast<double>(g.V) * (g.V - 1.0));
+
+    long long somaGraus = 0;
+    m.grauMinimo = g.V > 0 ? numeric_limits<int>::max() : 0;
+    for (int v = 1; v <= g.V; ++v)
+    {
+        const int grau = g.adjacencia.grauArestas(v);
+        m.grauMinimo = min(m.grauMinimo, grau);
+        m.grauMaximo = max(m.grauMaximo, grau);
+        somaGraus += grau;
+    }
+    m.grauMedio = g.V > 0 ? static_cast<double>(somaGraus) / g.V : 0.0;
+    m.intermediacao = static_cast<float>(calcularIntermediacaoBrandes(g, numThreads).media());
+}
+
+// Métricas a partir das linhas de distâncias de cada nó: obterLinha(i) devolve a linha de i (índices 1..V,
+// valores brutos), seja de uma matriz já calculada ou de um oráculo (ex.: Dijkstra por origem).
+template <class ObterLinha>
+MetricasGrafo calcularMetricas(const Grafo &g, ObterLinha obterLinha, int numThreads = 0)
+{
+    MetricasGrafo m;
+    calcularMetricasEstruturais(g, m, numThreads);
+    AcumuladorDistancias acumulador(g.V);
+    for (int i = 1; i <= g.V; ++i)
+        acumulador.acumularLinha(i, obterLinha(i));
+    acumulador.finalizar(m);
+    return m;
+}
+
+// Métricas a partir de uma matriz de distâncias já calculada.
+MetricasGrafo calcularMetricas(const Grafo &g, VisaoMatrizDistancias dist, int numThreads = 0)
+{
+    return calcularMetricas(g, [&](int i)
+                            { return dist.linha(i); }, numThreads);
+}
+
+// Cabeçalho e linha do CSV de métricas. As colunas básicas são as da Etapa 1 (imprimirMetricas);
+// a versão estendida acrescenta grau médio e alcançabilidade.
+void escreverCabecalhoMetricas(ostream &csv)
+{
+    csv << "Instancia,VerticesRequeridos,ArestasRequeridas,ArcosRequeridos,Densidade,GrauMinimo,GrauMaximo,"
+           "Diametro,CaminhoMedio,Intermediacao,GrauMedio,Alcancabilidade\n";
+}
+
+void escreverLinhaMetricas(ostream &csv, const string &nome, const MetricasGrafo &m, bool estendida = false)
+{
+    csv << nome << ","
+        << m.verticesRequeridos << ","
+        << m.arestasRequeridas << ","
+        << m.arcosRequeridos << ","
+        << m.densidade << ","
+        << m.grauMinimo << ","
+        << m.grauMaximo << ","
+        << (m.diametro == LONGLONG_INF ? "INF" : std::to_string(m.diametro)) << ","
+        << m.caminhoMedio << ","
+        << m.intermediacao;
+    if (estendida)
+        csv << "," << m.grauMedio << "," << m.alcancabilidade;
+    csv << "\n";
+}
+
+#endif // METRICAS_HPP
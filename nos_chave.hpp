@@ -0,0 +1,120 @@
+#ifndef NOS_CHAVE_HPP
+#define NOS_CHAVE_HPP
+
+#include <vector>
+#include <algorithm>
+
+#include "grafo.hpp"              // DadosInstancia, Servico
+#include "oraculo_distancias.hpp" // OraculoDistancias, MatrizDistancias
+
+using namespace std;
+
+// Compressão por "nós-chave": apenas o depósito e as extremidades dos serviços requeridos
+// aparecem como pontos de parada das rotas. Esses K nós recebem IDs remapeados 1..K e suas
+// distâncias ficam em uma matriz KxK compacta, em vez da matriz VxV completa.
+struct NosChave
+{
+    vector<int> noDaChave;  // Chave (1..K) -> nó original; índice 0 não usado
+    vector<int> chaveDoNo;  // Nó original (0..V) -> chave (0 = não é nó-chave ou nó inválido)
+    int chaveDeposito = 0;  // Chave do depósito (0 se o depósito for inválido)
+    MatrizDistancias dist;  // Distâncias mínimas entre nós-chave, indexadas pelas chaves
+
+    int numChaves() const { return static_cast<int>(noDaChave.size()) - 1; }
+};
+
+// Registra um nó como nó-chave (se ainda não for) e retorna sua chave. Nós fora de 1..V retornam 0.
+int registrarNoChave(NosChave &nos, int no)
+{
+    if (no <= 0 || no >= static_cast<int>(nos.chaveDoNo.size()))
+        return 0;
+    if (nos.chaveDoNo[no] == 0)
+    {
+        nos.chaveDoNo[no] = static_cast<int>(nos.noDaChave.size());
+        nos.noDaChave.push_back(no);
+    }
+    return nos.chaveDoNo[no];
+}
+
+// Identifica os nós-chave da instância (depósito primeiro, depois as extremidades dos serviços na
+// ordem da lista) e preenche chaveU/chaveV de cada serviço, sem calcular a matriz. Retorna K, o que
+// permite conferir o tamanho da matriz KxK antes de alocá-la.
+int identificarNosChave(const DadosInstancia &dados, vector<Servico> &servicos, NosChave &nos)
+{
+    nos.noDaChave.assign(1, 0); // Índice 0 não usado (chaves baseadas em 1)
+    nos.chaveDoNo.assign(dados.g.V + 1, 0);
+    nos.chaveDeposito = registrarNoChave(nos, dados.idNoDeposito);
+
+    for (auto &servico : servicos)
+    {
+        if (servico.tipo == Servico::Tipo::NO)
+        {
+            servico.chaveU = servico.chaveV = registrarNoChave(nos, servico.idNoOriginal);
+        }
+        else
+        {
+            servico.chaveU = registrarNoChave(nos, servico.uOriginal);
+            servico.chaveV = registrarNoChave(nos, servico.vOriginal);
+        }
+    }
+    return nos.numChaves();
+}
+
+// Calcula a matriz KxK dos nós-chave já identificados a partir do oráculo. Cada linha do oráculo é
+// consultada uma única vez, então com o oráculo esparso o custo é de K execuções de Dijkstra e nenhuma
+// matriz VxV é alocada, mas a matriz KxK de 64 bits é sempre densa (ver limiteNosChave).
+void calcularMatrizNosChave(NosChave &nos, OraculoDistancias &oraculo)
+{
+    const int K = nos.numChaves();
+    nos.dist.redimensionar(K);
+    for (int a = 1; a <= K; ++a)
+    {
+        const long long *linhaOrigem = oraculo.linha(nos.noDaChave[a]);
+        long long *linhaChave = nos.dist.linha(a);
+        for (int b = 1; b <= K; ++b)
+        {
+            linhaChave[b] = linhaOrigem[nos.noDaChave[b]]; // Copia o valor bruto (mantém o sentinela de infinito)
+        }
+    }
+}
+
+// Identifica os nós-chave e calcula a matriz KxK. Escreve em nos, reaproveitando seus buffers.
+void construirNosChave(const DadosInstancia &dados, vector<Servico> &servicos, OraculoDistancias &oraculo, NosChave &nos)
+{
+    identificarNosChave(dados, servicos, nos);
+    calcularMatrizNosChave(nos, oraculo);
+}
+
+NosChave construirNosChave(const DadosInstancia &dados, vector<Servico> &servicos, OraculoDistancias &oraculo)
+{
+    NosChave nos;
+    construirNosChave(dados, servicos, oraculo, nos);
+    return nos;
+}
+
+// Garante que o nó seja um nó-chave depois de a matriz KxK já estar calculada (por exemplo, para um serviço
+// novo). Se o nó ainda não for chave, a matriz cresce para (K+1)x(K+1): a linha nova vem de uma consulta ao
+// oráculo e a coluna nova de uma leitura por linha das chaves existentes (sem custo extra com a matriz
+// completa; com Dijkstra sob demanda, as linhas fora do cache são recalculadas). Retorna a chave ou 0.
+int adicionarNoChave(NosChave &nos, int no, OraculoDistancias &oraculo)
+{
+    if (no <= 0 || no >= static_cast<int>(nos.chaveDoNo.size()))
+        return 0;
+    if (nos.chaveDoNo[no] != 0)
+        return nos.chaveDoNo[no];
+
+    const int K = nos.numChaves();
+    MatrizDistancias ampliada(K + 1);
+    for (int a = 1; a <= K; ++a)
+    {
+        copy(nos.dist.linha(a) + 1, nos.dist.linha(a) + K + 1, ampliada.linha(a) + 1);
+        ampliada.bruto(a, K + 1) = oraculo.linha(nos.noDaChave[a])[no];
+    }
+    const int chave = registrarNoChave(nos, no);
+    const long long *linhaNo = oraculo.linha(no);
+    for (int b = 1; b <= K + 1; ++b)
+        ampliada.bruto(chave, b) = linhaNo[nos.noDaChave[b]];
+    nos.dist = std::move(ampliada);
+    return chave;
+}
+
+#endif // NOS_CHAVE_HPP
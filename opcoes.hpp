@@ -0,0 +1,382 @@
+#ifndef OPCOES_HPP
+#define OPCOES_HPP
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+
+#include "matriz_distancias.hpp"  // ConfigFloydWarshall
+#include "oraculo_distancias.hpp" // ConfigOraculo
+#include "candidatos.hpp"         // TAMANHO_LISTA_CANDIDATOS
+#include "busca_local.hpp"        // ConfigBuscaLocal
+#include "busca_local_iterada.hpp" // ConfigMetaheuristica
+#include "grasp.hpp"              // ConfigGrasp
+
+using namespace std;
+
+// Heurística que gera a solução inicial.
+enum class ModoConstrutivo
+{
+    GULOSO, // Vizinho mais próximo rota a rota (construtivo.hpp)
+    SPLIT   // Rota gigante dividida de forma ótima pelo Split (split.hpp)
+};
+
+// Opções de execução do programa, lidas da linha de comando.
+struct OpcoesExecucao
+{
+    // Caminho para a pasta contendo os arquivos de instância .dat (ou para um arquivo .zip com eles)
+    // !!! ATENÇÃO: Este caminho padrão deve ser ajustado para o seu ambiente local (ou passado como argumento) !!!
+    string pastaInstancias = "C:\\Users\\lidio\\Downloads\\MCGRP";
+    ConfigFloydWarshall configFW; // Threads, limiar do modo paralelo e tamanho de bloco do Floyd-Warshall
+    ConfigOraculo configOraculo;  // Matriz completa ou Dijkstra sob demanda com cache LRU
+    int instanciasParalelas = 1;  // Instâncias processadas simultaneamente (0 = número de núcleos)
+    int profundidadeFila = 2;     // Capacidade das filas entre leitura, resolução e escrita no lote
+    bool leituraMapeada = true;   // Parsing com o arquivo mapeado em memória (false = getline/istringstream)
+    string pastaCache;            // Pasta do cache binário de instâncias pré-processadas (vazia = sem cache)
+    string arquivoMetricas;       // CSV com as métricas do grafo de cada instância (vazio = não calcula)
+    int tamanhoListaCandidatos = TAMANHO_LISTA_CANDIDATOS; // Candidatos guardados por nó-chave no construtivo
+    ModoConstrutivo construtivo = ModoConstrutivo::GULOSO;
+    ConfigBuscaLocal configBuscaLocal; // Estratégia da busca local e tamanho máximo dos segmentos movidos
+    ConfigMetaheuristica configMetaheuristica; // Orçamento, critério de parada e semente da ILS
+    ConfigGrasp configGrasp;      // Construções, threads e lista restrita de candidatos do GRASP
+    bool rotasExpandidas = false; // Grava também rotas-*.dat com a sequência completa de nós de cada rota
+    bool solucaoBinaria = false;  // Grava também sol-*.bin, a solução em formato binário compacto
+};
+
+// Imprime a forma de uso do programa.
+void imprimirUso(const char *nomePrograma)
+{
+    cout << "Uso: " << nomePrograma << " [pasta_instancias | instancias.zip] [opcoes]\n"
+         << "  --threads N       Threads do Floyd-Warshall paralelo (0 = numero de nucleos)\n"
+         << "  --limiar-fw N     Numero minimo de nos para usar o Floyd-Warshall paralelo (padrao "
+         << LIMIAR_FW_PARALELO << ")\n"
+         << "  --bloco-fw N      Tamanho dos blocos do Floyd-Warshall (padrao " << TAMANHO_BLOCO_FW << ")\n"
+         << "  --oraculo M       Calculo das distancias: auto, matriz ou dijkstra (padrao auto)\n"
+         << "  --limiar-denso N  No modo auto, maior numero de nos que usa a matriz completa (padrao "
+         << LIMIAR_ORACULO_DENSO << ");\n"
+         << "                    com Dijkstra, instancias com mais de N nos-chave sao recusadas\n"
+         << "  --linhas-cache N  Linhas mantidas no cache LRU do modo dijkstra (padrao " << LINHAS_CACHE_ORACULO
+         << "); as distancias entre nos-chave\n"
+         << "                    ficam sempre em uma matriz KxK, entao o cache so afeta as metricas\n"
+         << "  --precisao P      Largura da matriz de distancias: auto (32 bits quando cabe) ou 64 (padrao auto)\n"
+         << "  --instancias N    Instancias processadas em paralelo (0 = numero de nucleos, padrao 1)\n"
+         << "  --fila N          Instancias lidas antecipadamente / aguardando escrita no lote (padrao 2)\n"
+         << "  --leitor L        Leitura das instancias: mmap ou fluxo (padrao mmap)\n"
+         << "  --cache PASTA     Guarda/reusa instancias pre-processadas (grafo e distancias) nesta pasta\n"
+         << "  --metricas ARQ    Grava as metricas do grafo (Etapa 1) de cada instancia no CSV ARQ\n"
+         << "  --candidatos N    Servicos mais proximos guardados por no-chave no construtivo (padrao "
+         << TAMANHO_LISTA_CANDIDATOS << ")\n"
+         << "  --construtivo C   Solucao inicial: guloso ou split (rota gigante + Split, padrao guloso)\n"
+         << "  --busca-local M   Busca local: nenhuma, primeira (primeira melhora) ou melhor (padrao primeira)\n"
+         << "  --segmento-max N  Maior segmento movido pela busca local (padrao " << TAMANHO_SEGMENTO_BL << ")\n"
+         << "  --tempo S         Executa a ILS por ate S segundos por instancia\n"
+         << "  --iteracoes N     Executa a ILS por ate N iteracoes por instancia\n"
+         << "  --sem-melhora N   Para a ILS apos N iteracoes sem melhorar a melhor solucao\n"
+         << "  --grasp N         Constroi N solucoes randomizadas em paralelo (GRASP) apos a busca local\n"
+         << "  --grasp-threads N Threads do GRASP (0 = numero de nucleos)\n"
+         << "  --rcl K           GRASP sorteia entre os K candidatos mais baratos (padrao " << TAMANHO_RCL << ")\n"
+         << "  --alfa A          GRASP sorteia entre os candidatos com custo <= min + A (max - min), 0 <= A <= 1\n"
+         << "  --semente N       Semente dos geradores pseudoaleatorios do GRASP e da ILS (padrao 1)\n"
+         << "  --rotas-expandidas Grava rotas-NOME.dat com a sequencia completa de nos de cada rota\n"
+         << "  --solucao-binaria Grava tambem sol-NOME.bin, a solucao em formato binario compacto\n"
+         << "  --ajuda           Mostra esta mensagem\n";
+}
+
+// Lê um argumento inteiro da opção na posição i (avançando i). Retorna false se faltar, estiver vazio,
+// não for um número inteiro ou não couber em um int.
+bool lerArgumentoInteiro(int argc, char *argv[], int &i, int &destino)
+{
+    if (i + 1 >= argc)
+    {
+        cerr << "Opcao " << argv[i] << " requer um valor." << endl;
+        return false;
+    }
+    char *fimNumero;
+    errno = 0;
+    long valor = strtol(argv[i + 1], &fimNumero, 10);
+    if (fimNumero == argv[i + 1] || *fimNumero != '\0' || errno == ERANGE || valor < INT_MIN || valor > INT_MAX)
+    {
+        cerr << "Valor invalido para " << argv[i] << ": " << argv[i + 1] << endl;
+        return false;
+    }
+    destino = static_cast<int>(valor);
+    i++;
+    return true;
+}
+
+// Lê um argumento real não negativo da opção na posição i (avançando i). Retorna false se faltar ou for inválido.
+bool lerArgumentoReal(int argc, char *argv[], int &i, double &destino)
+{
+    if (i + 1 >= argc)
+    {
+        cerr << "Opcao " << argv[i] << " requer um valor." << endl;
+        return false;
+    }
+    char *fimNumero;
+    double valor = strtod(argv[i + 1], &fimNumero);
+    if (*fimNumero != '\0' || valor < 0)
+    {
+        cerr << "Valor invalido para " << argv[i] << ": " << argv[i + 1] << endl;
+        return false;
+    }
+    destino = valor;
+    i++;
+    return true;
+}
+
+// Lê as opções da linha de comando. Retorna false se houver erro ou se a ajuda foi pedida.
+bool lerOpcoes(int argc, char *argv[], OpcoesExecucao &opcoes)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--ajuda" || arg == "-h")
+        {
+            imprimirUso(argv[0]);
+            return false;
+        }
+        else if (arg == "--threads")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.configFW.numThreads))
+                return false;
+        }
+        else if (arg == "--limiar-fw")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.configFW.limiarParalelo))
+                return false;
+        }
+        else if (arg == "--bloco-fw")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.configFW.tamanhoBloco))
+                return false;
+            if (opcoes.configFW.tamanhoBloco <= 0)
+            {
+                cerr << "Tamanho de bloco invalido." << endl;
+                return false;
+            }
+        }
+        else if (arg == "--oraculo")
+        {
+            string modo = i + 1 < argc ? argv[++i] : "";
+            if (modo == "auto")
+                opcoes.configOraculo.modo = ModoOraculo::AUTO;
+            else if (modo == "matriz")
+                opcoes.configOraculo.modo = ModoOraculo::MATRIZ;
+            else if (modo == "dijkstra")
+                opcoes.configOraculo.modo = ModoOraculo::DIJKSTRA;
+            else
+            {
+                cerr << "Modo de oraculo invalido: " << modo << endl;
+                return false;
+            }
+        }
+        else if (arg == "--precisao")
+        {
+            string precisao = i + 1 < argc ? argv[++i] : "";
+            if (precisao == "auto")
+                opcoes.configOraculo.precisao = PrecisaoDistancias::AUTO;
+            else if (precisao == "64")
+                opcoes.configOraculo.precisao = PrecisaoDistancias::BITS_64;
+            else
+            {
+                cerr << "Precisao invalida: " << precisao << endl;
+                return false;
+            }
+        }
+        else if (arg == "--limiar-denso")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.configOraculo.limiarDenso))
+                return false;
+            if (opcoes.configOraculo.limiarDenso <= 0)
+            {
+                cerr << "Limiar do oraculo denso invalido." << endl;
+                return false;
+            }
+        }
+        else if (arg == "--linhas-cache")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.configOraculo.linhasCache))
+                return false;
+            if (opcoes.configOraculo.linhasCache < 2) // Mesmo mínimo do OraculoDijkstra
+            {
+                cerr << "Numero de linhas do cache invalido (minimo 2)." << endl;
+                return false;
+            }
+        }
+        else if (arg == "--instancias")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.instanciasParalelas))
+                return false;
+            if (opcoes.instanciasParalelas < 0)
+            {
+                cerr << "Numero de instancias paralelas invalido." << endl;
+                return false;
+            }
+        }
+        else if (arg == "--fila")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.profundidadeFila))
+                return false;
+            if (opcoes.profundidadeFila <= 0)
+            {
+                cerr << "Capacidade de fila invalida." << endl;
+                return false;
+            }
+        }
+        else if (arg == "--leitor")
+        {
+            string leitor = i + 1 < argc ? argv[++i] : "";
+            if (leitor == "mmap")
+                opcoes.leituraMapeada = true;
+            else if (leitor == "fluxo")
+                opcoes.leituraMapeada = false;
+            else
+            {
+                cerr << "Leitor invalido: " << leitor << endl;
+                return false;
+            }
+        }
+        else if (arg == "--candidatos")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.tamanhoListaCandidatos))
+                return false;
+            if (opcoes.tamanhoListaCandidatos <= 0)
+            {
+                cerr << "Tamanho da lista de candidatos invalido." << endl;
+                return false;
+            }
+        }
+        else if (arg == "--construtivo")
+        {
+            string construtivo = i + 1 < argc ? argv[++i] : "";
+            if (construtivo == "guloso")
+                opcoes.construtivo = ModoConstrutivo::GULOSO;
+            else if (construtivo == "split")
+                opcoes.construtivo = ModoConstrutivo::SPLIT;
+            else
+            {
+                cerr << "Construtivo invalido: " << construtivo << endl;
+                return false;
+            }
+        }
+        else if (arg == "--busca-local")
+        {
+            string modo = i + 1 < argc ? argv[++i] : "";
+            if (modo == "nenhuma")
+                opcoes.configBuscaLocal.modo = ModoBuscaLocal::NENHUMA;
+            else if (modo == "primeira")
+                opcoes.configBuscaLocal.modo = ModoBuscaLocal::PRIMEIRA;
+            else if (modo == "melhor")
+                opcoes.configBuscaLocal.modo = ModoBuscaLocal::MELHOR;
+            else
+            {
+                cerr << "Modo de busca local invalido: " << modo << endl;
+                return false;
+            }
+        }
+        else if (arg == "--segmento-max")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.configBuscaLocal.tamanhoMaxSegmento))
+                return false;
+            if (opcoes.configBuscaLocal.tamanhoMaxSegmento <= 0)
+            {
+                cerr << "Tamanho maximo de segmento invalido." << endl;
+                return false;
+            }
+        }
+        else if (arg == "--tempo")
+        {
+            if (!lerArgumentoReal(argc, argv, i, opcoes.configMetaheuristica.tempoLimite))
+                return false;
+        }
+        else if (arg == "--iteracoes" || arg == "--sem-melhora" || arg == "--semente")
+        {
+            int valor;
+            if (!lerArgumentoInteiro(argc, argv, i, valor))
+                return false;
+            if (valor < 0)
+            {
+                cerr << "Valor invalido para " << arg << ": " << valor << endl;
+                return false;
+            }
+            if (arg == "--iteracoes")
+                opcoes.configMetaheuristica.maxIteracoes = valor;
+            else if (arg == "--sem-melhora")
+                opcoes.configMetaheuristica.maxSemMelhora = valor;
+            else
+                opcoes.configMetaheuristica.semente = opcoes.configGrasp.semente = valor;
+        }
+        else if (arg == "--grasp" || arg == "--grasp-threads")
+        {
+            int &destino = arg == "--grasp" ? opcoes.configGrasp.construcoes : opcoes.configGrasp.numThreads;
+            if (!lerArgumentoInteiro(argc, argv, i, destino))
+                return false;
+            if (destino < 0)
+            {
+                cerr << "Valor invalido para " << arg << ": " << destino << endl;
+                return false;
+            }
+        }
+        else if (arg == "--rcl")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.configGrasp.tamanhoRCL))
+                return false;
+            if (opcoes.configGrasp.tamanhoRCL <= 0)
+            {
+                cerr << "Tamanho da RCL invalido." << endl;
+                return false;
+            }
+        }
+        else if (arg == "--alfa")
+        {
+            if (!lerArgumentoReal(argc, argv, i, opcoes.configGrasp.alfa))
+                return false;
+            if (opcoes.configGrasp.alfa > 1)
+            {
+                cerr << "Valor de alfa invalido (deve estar entre 0 e 1)." << endl;
+                return false;
+            }
+        }
+        else if (arg == "--cache")
+        {
+            if (i + 1 >= argc)
+            {
+                cerr << "Opcao --cache requer uma pasta." << endl;
+                return false;
+            }
+            opcoes.pastaCache = argv[++i];
+        }
+        else if (arg == "--rotas-expandidas")
+        {
+            opcoes.rotasExpandidas = true;
+        }
+        else if (arg == "--solucao-binaria")
+        {
+            opcoes.solucaoBinaria = true;
+        }
+        else if (arg == "--metricas")
+        {
+            if (i + 1 >= argc)
+            {
+                cerr << "Opcao --metricas requer um arquivo." << endl;
+                return false;
+            }
+            opcoes.arquivoMetricas = argv[++i];
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            cerr << "Opcao desconhecida: " << arg << endl;
+            imprimirUso(argv[0]);
+            return false;
+        }
+        else
+        {
+            opcoes.pastaInstancias = arg;
+        }
+    }
+    return true;
+}
+
+#endif // OPCOES_HPP
@@ -0,0 +1,273 @@
+#ifndef ORACULO_DISTANCIAS_HPP
+#define ORACULO_DISTANCIAS_HPP
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <type_traits>
+#include <climits>
+
+#include "grafo.hpp"   // Grafo e listas de adjacência
+#include "funcoes.hpp" // floydWarshall, MatrizDistancias e sentinelas de infinito
+
+using namespace std;
+
+// Visão de leitura de uma linha de distâncias que converte o sentinela interno para LONGLONG_INF.
+struct LinhaDistancias
+{
+    const long long *dados;
+
+    long long operator[](int j) const
+    {
+        long long d = dados[j];
+        return d >= DIST_INF_SATURADO ? LONGLONG_INF : d;
+    }
+};
+
+// Interface de consulta de distâncias mínimas a partir de uma origem.
+// Permite trocar a matriz completa (Floyd-Warshall) por um cálculo sob demanda em grafos grandes.
+class OraculoDistancias
+{
+public:
+    virtual ~OraculoDistancias() = default;
+
+    virtual int numVertices() const = 0;
+
+    // Retorna a linha de distâncias a partir de origem (índices 1..V, valores brutos com DIST_INF_SATURADO).
+    // O ponteiro permanece válido ao menos até a próxima chamada de linha() com outra origem.
+    virtual const long long *linha(int origem) = 0;
+
+    LinhaDistancias linhaDistancias(int origem) { return {linha(origem)}; }
+
+    // Distância mínima de origem a destino (LONGLONG_INF se não houver caminho).
+    long long distancia(int origem, int destino) { return linhaDistancias(origem)[destino]; }
+};
+
+// Oráculo sobre a matriz completa de distâncias (todas as linhas já calculadas).
+// Com a matriz de 32 bits, cada linha consultada é convertida para 64 bits (e o sentinela para
+// DIST_INF_SATURADO) em um buffer próprio; os consumidores leem cada linha uma única vez.
+// Se devolucao não for nulo, a matriz é devolvida para lá na destruição do oráculo (ver ReservaMatrizes).
+template <typename Custo>
+class OraculoMatrizT : public OraculoDistancias
+{
+public:
+    OraculoMatrizT(MatrizDistanciasT<Custo> matriz_, MatrizDistanciasT<Custo> *devolucao_ = nullptr)
+        : matriz(std::move(matriz_)), devolucao(devolucao_) {}
+
+    ~OraculoMatrizT() override
+    {
+        if (devolucao)
+            *devolucao = std::move(matriz);
+    }
+
+    int numVertices() const override { return matriz.numVertices(); }
+
+    const long long *linha(int origem) override
+    {
+        if constexpr (is_same<Custo, long long>::value)
+        {
+            return matriz.linha(origem);
+        }
+        else
+        {
+            const Custo *bruta = matriz.linha(origem);
+            const int n = matriz.numVertices();
+            linhaConvertida.resize(static_cast<size_t>(n) + 1);
+            for (int j = 0; j <= n; ++j)
+                linhaConvertida[j] = bruta[j] >= infSaturado<Custo>() ? DIST_INF_SATURADO : static_cast<long long>(bruta[j]);
+            return linhaConvertida.data();
+        }
+    }
+
+    const MatrizDistanciasT<Custo> &matrizCompleta() const { return matriz; }
+
+private:
+    MatrizDistanciasT<Custo> matriz;
+    MatrizDistanciasT<Custo> *devolucao;
+    vector<long long> linhaConvertida; // Usado apenas com Custo de 32 bits
+};
+
+using OraculoMatriz = OraculoMatrizT<long long>;
+
+// Preenche dist[1..V] com as distâncias mínimas a partir de origem usando Dijkstra com heap binário.
+// Percorre arestas (nos dois sentidos) e arcos; nós inalcançáveis ficam com DIST_INF_SATURADO.
+// Se predecessor não for nulo, registra em predecessor[1..V] o nó anterior na árvore de caminhos mínimos
+// (0 para a origem e para os nós inalcançáveis).
+void dijkstraUmaOrigem(const Grafo &g, int origem, long long *dist, int *predecessor = nullptr)
+{
+    fill(dist, dist + g.V + 1, DIST_INF_SATURADO);
+    if (predecessor)
+        fill(predecessor, predecessor + g.V + 1, 0);
+    if (origem <= 0 || origem > g.V)
+        return;
+
+    using ItemHeap = pair<long long, int>; // (distância, nó)
+    priority_queue<ItemHeap, vector<ItemHeap>, greater<ItemHeap>> heap;
+    dist[origem] = 0;
+    heap.push({0, origem});
+
+    while (!heap.empty())
+    {
+        auto [d, u] = heap.top();
+        heap.pop();
+        if (d > dist[u])
+            continue; // Entrada obsoleta no heap
+
+        // Arestas e arcos de saída de u, contíguos na adjacência CSR
+        for (const auto &suc : g.adjacencia.de(u))
+        {
+            long long nd = d + suc.custo;
+            if (nd < dist[suc.destino])
+            {
+                dist[suc.destino] = nd;
+                if (predecessor)
+                    predecessor[suc.destino] = u;
+                heap.push({nd, suc.destino});
+            }
+        }
+    }
+}
+
+// Oráculo esparso: calcula cada linha com Dijkstra na primeira consulta e mantém
+// as linhas mais recentes em um cache LRU de capacidade fixa.
+// Memória do oráculo O(linhasCache x V) e tempo proporcional ao número de origens realmente consultadas.
+// As heurísticas não consultam o oráculo: leem a matriz KxK de nós-chave (nos_chave.hpp), que copia cada
+// linha uma única vez. Para que essa matriz não anule a economia de memória, a preparação recusa instâncias
+// com mais de limiteNosChave nós-chave quando o oráculo é esparso.
+class OraculoDijkstra : public OraculoDistancias
+{
+public:
+    OraculoDijkstra(const Grafo &g_, int linhas_cache) : g(g_), capacidade(max(2, linhas_cache))
+    {
+        passoLinha = static_cast<size_t>(g.V) + 1;
+        buffer.assign(passoLinha * capacidade, DIST_INF_SATURADO);
+        origemDoSlot.assign(capacidade, -1);
+        ultimoUso.assign(capacidade, 0);
+        slotDaOrigem.assign(g.V + 1, -1);
+    }
+
+    int numVertices() const override { return g.V; }
+
+    const long long *linha(int origem) override
+    {
+        relogio++;
+        int slot = slotDaOrigem[origem];
+        if (slot != -1)
+        {
+            acertos++;
+            ultimoUso[slot] = relogio;
+            return buffer.data() + slot * passoLinha;
+        }
+
+        // Falta no cache: usa um slot livre ou descarta a linha usada há mais tempo
+        falhas++;
+        slot = 0;
+        for (int s = 1; s < capacidade; ++s)
+        {
+            if (ultimoUso[s] < ultimoUso[slot])
+                slot = s;
+        }
+        if (origemDoSlot[slot] != -1)
+            slotDaOrigem[origemDoSlot[slot]] = -1;
+
+        long long *dist = buffer.data() + slot * passoLinha;
+        dijkstraUmaOrigem(g, origem, dist);
+        origemDoSlot[slot] = origem;
+        slotDaOrigem[origem] = slot;
+        ultimoUso[slot] = relogio;
+        return dist;
+    }
+
+    long long numAcertos() const { return acertos; }
+    long long numFalhas() const { return falhas; }
+
+private:
+    const Grafo &g;
+    int capacidade;
+    size_t passoLinha;
+    vector<long long> buffer;      // capacidade linhas de V+1 distâncias
+    vector<int> origemDoSlot;      // Origem armazenada em cada slot (-1 = livre)
+    vector<long long> ultimoUso;   // Instante do último acesso a cada slot
+    vector<int> slotDaOrigem;      // Slot de cada origem (-1 = fora do cache)
+    long long relogio = 0;
+    long long acertos = 0, falhas = 0;
+};
+
+// Estratégia de cálculo das distâncias usada pelo construtivo.
+enum class ModoOraculo
+{
+    AUTO,    // Matriz completa até limiarDenso nós, Dijkstra sob demanda acima disso
+    MATRIZ,  // Sempre Floyd-Warshall
+    DIJKSTRA // Sempre Dijkstra sob demanda com cache LRU
+};
+
+// Número padrão de nós a partir do qual o modo AUTO deixa de calcular a matriz completa.
+// 4096 nós correspondem a uma matriz de ~128 MB.
+const int LIMIAR_ORACULO_DENSO = 4096;
+
+// Número padrão de linhas mantidas no cache do oráculo esparso.
+const int LINHAS_CACHE_ORACULO = 64;
+
+// Largura das distâncias na matriz completa.
+enum class PrecisaoDistancias
+{
+    AUTO,    // 32 bits quando custosCabemEm32Bits(g), 64 bits caso contrário
+    BITS_64  // Sempre 64 bits
+};
+
+struct ConfigOraculo
+{
+    ModoOraculo modo = ModoOraculo::AUTO;
+    PrecisaoDistancias precisao = PrecisaoDistancias::AUTO;
+    int limiarDenso = LIMIAR_ORACULO_DENSO;
+    int linhasCache = LINHAS_CACHE_ORACULO;
+};
+
+// Matrizes completas guardadas entre instâncias (uma por largura): o oráculo de uma instância calcula o
+// Floyd-Warshall no buffer deixado pela anterior e o devolve ao ser destruído, em vez de alocar e liberar
+// (V+1)^2 elementos por instância.
+struct ReservaMatrizes
+{
+    MatrizDistanciasT<int32_t> matriz32;
+    MatrizDistancias matriz64;
+};
+
+// Indica se o oráculo escolhido para o grafo é a matriz completa (Floyd-Warshall) ou o esparso (Dijkstra).
+bool usarMatrizCompleta(const Grafo &g, const ConfigOraculo &config)
+{
+    return config.modo == ModoOraculo::MATRIZ || (config.modo == ModoOraculo::AUTO && g.V <= config.limiarDenso);
+}
+
+// Maior número de nós-chave aceito para o grafo. Com a matriz completa a matriz KxK é menor que ela e não há
+// limite; com o oráculo esparso, K fica limitado a limiarDenso, o mesmo tamanho de matriz que o modo AUTO
+// ainda aceita calcular por completo.
+int limiteNosChave(const Grafo &g, const ConfigOraculo &config)
+{
+    return usarMatrizCompleta(g, config) ? INT_MAX : config.limiarDenso;
+}
+
+// Cria o oráculo de distâncias adequado ao tamanho do grafo.
+// O grafo (e a reserva, se informada) deve permanecer vivo enquanto o oráculo for usado.
+unique_ptr<OraculoDistancias> criarOraculoDistancias(const Grafo &g, const ConfigOraculo &config,
+                                                     const ConfigFloydWarshall &configFW,
+                                                     ReservaMatrizes *reserva = nullptr)
+{
+    if (usarMatrizCompleta(g, config))
+    {
+        // A matriz de 32 bits ocupa metade da memória e o núcleo relaxa o dobro de elementos por instrução
+        if (config.precisao == PrecisaoDistancias::AUTO && custosCabemEm32Bits(g))
+        {
+            if (!reserva)
+                return make_unique<OraculoMatrizT<int32_t>>(floydWarshallT<int32_t>(g, configFW));
+            floydWarshallT(g, configFW, reserva->matriz32);
+            return make_unique<OraculoMatrizT<int32_t>>(std::move(reserva->matriz32), &reserva->matriz32);
+        }
+        if (!reserva)
+            return make_unique<OraculoMatriz>(floydWarshall(g, configFW));
+        floydWarshallT(g, configFW, reserva->matriz64);
+        return make_unique<OraculoMatriz>(std::move(reserva->matriz64), &reserva->matriz64);
+    }
+    return make_unique<OraculoDijkstra>(g, config.linhasCache);
+}
+
+#endif // ORACULO_DISTANCIAS_HPP
@@ -0,0 +1,177 @@
+#ifndef POOL_THREADS_HPP
+#define POOL_THREADS_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <deque>
+
+using namespace std;
+
+// Retorna o número de threads a usar: o valor pedido, ou o número de núcleos se pedido <= 0.
+int resolverNumThreads(int pedido)
+{
+    if (pedido > 0)
+        return pedido;
+    unsigned int nucleos = thread::hardware_concurrency();
+    return nucleos > 0 ? static_cast<int>(nucleos) : 1;
+}
+
+// Pool fixo de threads para laços paralelos do tipo "fork-join".
+// A thread chamadora também executa tarefas, então um pool de N threads cria N-1 trabalhadores.
+class PoolThreads
+{
+public:
+    PoolThreads(int num_threads = 0) : numThreads(resolverNumThreads(num_threads))
+    {
+        for (int t = 1; t < numThreads; ++t)
+        {
+            trabalhadores.emplace_back([this]
+                                       { lacoTrabalhador(); });
+        }
+    }
+
+    ~PoolThreads()
+    {
+        {
+            lock_guard<mutex> trava(mtx);
+            encerrar = true;
+        }
+        cvInicio.notify_all();
+        for (auto &t : trabalhadores)
+            t.join();
+    }
+
+    PoolThreads(const PoolThreads &) = delete;
+    PoolThreads &operator=(const PoolThreads &) = delete;
+
+    int tamanho() const { return numThreads; }
+
+    // Executa tarefa(i) para i em [0, numTarefas) distribuindo entre as threads; retorna quando todas terminarem.
+    void executarParalelo(int numTarefas, const function<void(int)> &tarefa)
+    {
+        if (numTarefas <= 0)
+            return;
+        if (numThreads == 1 || numTarefas == 1)
+        {
+            for (int i = 0; i < numTarefas; ++i)
+                tarefa(i);
+            return;
+        }
+        {
+            lock_guard<mutex> trava(mtx);
+            tarefaAtual = &tarefa;
+            totalTarefas = numTarefas;
+            proximaTarefa.store(0);
+            trabalhadoresAtivos = static_cast<int>(trabalhadores.size());
+            geracao++;
+        }
+        cvInicio.notify_all();
+        consumirTarefas(tarefa, numTarefas);
+
+        unique_lock<mutex> trava(mtx);
+        cvFim.wait(trava, [this]
+                   { return trabalhadoresAtivos == 0; });
+        tarefaAtual = nullptr;
+    }
+
+private:
+    void consumirTarefas(const function<void(int)> &tarefa, int numTarefas)
+    {
+        for (int i = proximaTarefa.fetch_add(1); i < numTarefas; i = proximaTarefa.fetch_add(1))
+        {
+            tarefa(i);
+        }
+    }
+
+    void lacoTrabalhador()
+    {
+        long long geracaoVista = 0;
+        while (true)
+        {
+            const function<void(int)> *tarefa;
+            int numTarefas;
+            {
+                unique_lock<mutex> trava(mtx);
+                cvInicio.wait(trava, [&]
+                              { return encerrar || geracao != geracaoVista; });
+                if (encerrar)
+                    return;
+                geracaoVista = geracao;
+                tarefa = tarefaAtual;
+                numTarefas = totalTarefas;
+            }
+            consumirTarefas(*tarefa, numTarefas);
+            {
+                lock_guard<mutex> trava(mtx);
+                if (--trabalhadoresAtivos == 0)
+                    cvFim.notify_one();
+            }
+        }
+    }
+
+    int numThreads;
+    vector<thread> trabalhadores;
+    mutex mtx;
+    condition_variable cvInicio, cvFim;
+    const function<void(int)> *tarefaAtual = nullptr;
+    int totalTarefas = 0;
+    atomic<int> proximaTarefa{0};
+    int trabalhadoresAtivos = 0;
+    long long geracao = 0;
+    bool encerrar = false;
+};
+
+// Fila limitada que liga as etapas de um pipeline (vários produtores e consumidores).
+// inserir bloqueia enquanto a fila está cheia, o que segura a etapa anterior quando a seguinte atrasa
+// (contrapressão); retirar bloqueia enquanto ela está vazia. Depois de fechar, retirar entrega o que restou
+// e então retorna false. Os itens são grossos (instâncias inteiras), então um mutex simples basta.
+template <typename T>
+class FilaLimitada
+{
+public:
+    explicit FilaLimitada(size_t capacidade_) : capacidade(max<size_t>(1, capacidade_)) {}
+
+    void inserir(T item)
+    {
+        unique_lock<mutex> trava(mtx);
+        cvNaoCheia.wait(trava, [&]
+                        { return itens.size() < capacidade; });
+        itens.push_back(move(item));
+        cvNaoVazia.notify_one();
+    }
+
+    bool retirar(T &item)
+    {
+        unique_lock<mutex> trava(mtx);
+        cvNaoVazia.wait(trava, [&]
+                        { return !itens.empty() || fechada; });
+        if (itens.empty())
+            return false;
+        item = move(itens.front());
+        itens.pop_front();
+        cvNaoCheia.notify_one();
+        return true;
+    }
+
+    // Sinaliza que nada mais será inserido.
+    void fechar()
+    {
+        lock_guard<mutex> trava(mtx);
+        fechada = true;
+        cvNaoVazia.notify_all();
+    }
+
+private:
+    size_t capacidade;
+    deque<T> itens;
+    bool fechada = false;
+    mutex mtx;
+    condition_variable cvNaoCheia, cvNaoVazia;
+};
+
+#endif // POOL_THREADS_HPP
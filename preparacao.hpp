@@ -0,0 +1,258 @@
+#ifndef PREPARACAO_HPP
+#define PREPARACAO_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+
+#include "grafo.hpp"              // Grafo, Servico, DadosInstancia
+#include "matriz_distancias.hpp"  // VisaoMatrizDistancias, ConfigFloydWarshall
+#include "oraculo_distancias.hpp" // criarOraculoDistancias
+#include "nos_chave.hpp"          // NosChave, construirNosChave
+#include "leitura_rapida.hpp"     // lerInstanciaDeMemoria, EstatisticasLeitura
+#include "fonte_instancias.hpp"   // FonteInstancias, ConteudoInstancia
+#include "cache_instancias.hpp"   // Cache binário de instâncias pré-processadas
+#include "metricas.hpp"           // MetricasGrafo, calcularMetricas
+#include "opcoes.hpp"             // OpcoesExecucao
+
+using namespace std;
+
+// Lista de todos os serviços requeridos (com demanda > 0), com IDs sequenciais: nós, arestas e arcos.
+// Escreve em listaTodosServicos, reaproveitando a capacidade do vetor.
+void montarListaServicos(const Grafo &g, vector<Servico> &listaTodosServicos)
+{
+    listaTodosServicos.clear();
+    int idGlobalAtual = 1; // ID sequencial para cada serviço
+
+    for (const auto &noReq : g.vertices)
+    {
+        if (noReq.demanda > 0)
+        {
+            listaTodosServicos.push_back({idGlobalAtual++, Servico::Tipo::NO,
+                                          noReq.id, 0, 0,
+                                          noReq.demanda, noReq.s_custo, 0,
+                                          false,
+                                          noReq.id, noReq.id});
+        }
+    }
+    for (const auto &arestaReq : g.arestas)
+    {
+        if (arestaReq.demanda > 0)
+        {
+            listaTodosServicos.push_back({idGlobalAtual++, Servico::Tipo::ARESTA,
+                                          0, arestaReq.origem, arestaReq.destino,
+                                          arestaReq.demanda, arestaReq.s_custo, arestaReq.custo,
+                                          false,
+                                          0, 0});
+        }
+    }
+    for (const auto &arcoReq : g.arcos)
+    {
+        if (arcoReq.demanda > 0)
+        {
+            listaTodosServicos.push_back({idGlobalAtual++, Servico::Tipo::ARCO,
+                                          0, arcoReq.origem, arcoReq.destino,
+                                          arcoReq.demanda, arcoReq.s_custo, arcoReq.custo,
+                                          false,
+                                          arcoReq.origem, arcoReq.destino});
+        }
+    }
+}
+
+vector<Servico> montarListaServicos(const Grafo &g)
+{
+    vector<Servico> listaTodosServicos;
+    montarListaServicos(g, listaTodosServicos);
+    return listaTodosServicos;
+}
+
+// Tudo o que a heurística construtiva consome de uma instância: a lista de serviços e a matriz de
+// distâncias entre nós-chave. Os dados vêm do processamento completo (leitura + caminhos mínimos)
+// ou de um cache binário mapeado em memória; a heurística não distingue as duas origens.
+// No modo em lote as InstanciaPreparada circulam entre as etapas do pipeline e são reaproveitadas:
+// lerInstancia as reinicia sem liberar os vetores (grafo, adjacência, serviços e nós-chave), que passam a ser
+// reescritos no lugar e só crescem quando uma instância maior aparece.
+struct InstanciaPreparada
+{
+    string nomeInstancia;
+    int idNoDeposito = -1;
+    int capacidadeVeiculo = 0;
+    int numNos = 0;
+
+    vector<Servico> servicos;          // Cópia de trabalho (a heurística marca os serviços atendidos)
+    int chaveDeposito = 0;             // Nó-chave do depósito
+    const int *noDaChave = nullptr;    // Nó original de cada chave (índice 0 não usado)
+    VisaoMatrizDistancias distChaves;  // Distâncias entre nós-chave (1..K)
+
+    bool temMetricas = false;          // Métricas do grafo calculadas (opção --metricas)
+    MetricasGrafo metricas;
+    double segundosMetricas = 0;       // Tempo gasto nas métricas (fora do tempo da heurística)
+
+    bool carregadaDoCache = false;
+    string caminhoCache;               // Arquivo de cache usado ou gravado (vazio sem --cache)
+    uint64_t hashConteudo = 0;         // Hash do conteúdo do arquivo (chave do cache)
+    EstatisticasLeitura estatLeitura;
+
+    // Armazenamento dos dados apontados acima (apenas um deles é usado)
+    DadosInstancia dados;              // Instância lida nesta execução
+    NosChave nosChave;                 // Matriz de nós-chave calculada nesta execução
+    CacheInstanciaMapeado cache;       // Cache mapeado em memória
+
+    // Prepara a estrutura para a próxima instância, mantendo a memória já alocada.
+    void reiniciar()
+    {
+        idNoDeposito = -1;
+        capacidadeVeiculo = 0;
+        numNos = 0;
+        chaveDeposito = 0;
+        noDaChave = nullptr;
+        distChaves = VisaoMatrizDistancias();
+        temMetricas = false;
+        metricas = MetricasGrafo();
+        segundosMetricas = 0;
+        carregadaDoCache = false;
+        caminhoCache.clear();
+        hashConteudo = 0;
+        estatLeitura = EstatisticasLeitura();
+        cache = CacheInstanciaMapeado();
+    }
+};
+
+// Calcula as métricas do grafo sobre as linhas do oráculo já usado (ou a ser usado) pela heurística.
+void calcularMetricasInstancia(const Grafo &g, OraculoDistancias &oraculo, const ConfigFloydWarshall &configFW,
+                               InstanciaPreparada &inst)
+{
+    auto inicio = chrono::steady_clock::now();
+    inst.metricas = calcularMetricas(g, [&](int i)
+                                     { return oraculo.linha(i); }, configFW.numThreads);
+    inst.temMetricas = true;
+    inst.segundosMetricas = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+// A preparação é feita em duas partes, que no modo em lote rodam em etapas diferentes do pipeline:
+//   - lerInstancia: leitura da instância i da fonte. Com opcoes.pastaCache definida, procura primeiro um cache
+//     válido para o conteúdo do arquivo (pulando parsing e caminhos mínimos);
+//   - calcularDistanciasInstancia: lista de serviços, caminhos mínimos e matriz de nós-chave, ou só as métricas
+//     se a instância veio do cache. O cache para as próximas execuções é gravado depois, por
+//     gravarCacheInstanciaPreparada.
+
+// Primeira parte: retorna false (após escrever o erro) se a instância for inválida.
+bool lerInstancia(const FonteInstancias &fonte, int i, const OpcoesExecucao &opcoes, InstanciaPreparada &inst,
+                  ostream &erros)
+{
+    inst.reiniciar();
+    inst.nomeInstancia = fonte.nomeInstancia(i);
+    const bool usarCache = !opcoes.pastaCache.empty();
+
+    if (usarCache)
+    {
+        ConteudoInstancia conteudo;
+        if (!fonte.obterConteudo(i, conteudo, erros))
+        {
+            erros << "Erro ao ler dados da instancia ou instancia invalida: " << inst.nomeInstancia << endl;
+            return false;
+        }
+        inst.hashConteudo = hashConteudoInstancia(conteudo.texto);
+        inst.caminhoCache = caminhoCacheInstancia(opcoes.pastaCache, inst.nomeInstancia, inst.hashConteudo);
+
+        if (inst.cache.abrir(inst.caminhoCache, inst.hashConteudo))
+        {
+            const CabecalhoCache &cab = inst.cache.cabecalho();
+            inst.carregadaDoCache = true;
+            inst.idNoDeposito = cab.idNoDeposito;
+            inst.capacidadeVeiculo = cab.capacidadeVeiculo;
+            inst.numNos = cab.numNos;
+            inst.servicos.assign(inst.cache.servicos(), inst.cache.servicos() + cab.numServicos);
+            inst.chaveDeposito = cab.chaveDeposito;
+            inst.noDaChave = inst.cache.noDaChave();
+            inst.distChaves = inst.cache.distancias();
+            return true;
+        }
+
+        // Sem cache válido: parsing direto do conteúdo já carregado
+        auto inicio = chrono::steady_clock::now();
+        lerInstanciaDeMemoria(conteudo.texto, inst.nomeInstancia, inst.dados);
+        inst.estatLeitura.bytes = conteudo.texto.size();
+        inst.estatLeitura.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    }
+    else
+    {
+        fonte.ler(i, inst.dados, &inst.estatLeitura, erros);
+    }
+
+    if (inst.dados.idNoDeposito == -1 || inst.dados.g.V == 0)
+    {
+        erros << "Erro ao ler dados da instancia ou instancia invalida: " << inst.nomeInstancia << endl;
+        return false;
+    }
+    inst.idNoDeposito = inst.dados.idNoDeposito;
+    inst.capacidadeVeiculo = inst.dados.capacidadeVeiculo;
+    inst.numNos = inst.dados.g.V;
+    return true;
+}
+
+// Segunda parte, sobre uma instância lida por lerInstancia. reserva (opcional) guarda os buffers da matriz
+// completa entre chamadas; no lote há uma por trabalhador da etapa de resolução.
+// Retorna false (após escrever o erro) se a matriz de nós-chave passar do limite do oráculo esparso.
+bool calcularDistanciasInstancia(const OpcoesExecucao &opcoes, const ConfigFloydWarshall &configFW,
+                                 InstanciaPreparada &inst, ostream &erros, ReservaMatrizes *reserva = nullptr)
+{
+    if (inst.carregadaDoCache)
+    {
+        if (!opcoes.arquivoMetricas.empty())
+        {
+            // O cache guarda só a matriz entre nós-chave: as métricas precisam das distâncias completas, então o
+            // grafo e o oráculo (no modo matriz, um Floyd-Warshall completo) são refeitos só para elas e entram
+            // no tempo das métricas, que é descontado do tempo da heurística
+            auto inicio = chrono::steady_clock::now();
+            Grafo g = inst.cache.reconstruirGrafo();
+            unique_ptr<OraculoDistancias> oraculo = criarOraculoDistancias(g, opcoes.configOraculo, configFW);
+            calcularMetricasInstancia(g, *oraculo, configFW, inst);
+            inst.segundosMetricas = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        }
+        return true; // A matriz de nós-chave do cache é lida do arquivo mapeado, sem alocação
+    }
+
+    // Caminhos mínimos (matriz completa ou Dijkstra sob demanda) comprimidos para os nós-chave; com --metricas,
+    // as métricas do grafo usam o mesmo oráculo. Depois disso o oráculo (e a eventual matriz VxV) não é mais necessário.
+    montarListaServicos(inst.dados.g, inst.servicos);
+    const int K = identificarNosChave(inst.dados, inst.servicos, inst.nosChave);
+    if (K > limiteNosChave(inst.dados.g, opcoes.configOraculo))
+    {
+        // As heurísticas leem a matriz KxK densa; com o oráculo esparso ela anularia o limite de memória dele
+        erros << "Erro: " << inst.nomeInstancia << " tem " << K << " nos-chave, acima de --limiar-denso "
+              << opcoes.configOraculo.limiarDenso << "; a matriz de nos-chave ocuparia "
+              << (static_cast<double>(K) + 1) * (K + 1) * sizeof(long long) / (1 << 20)
+              << " MB. Use --limiar-denso " << K << " (ou maior) para aceitar essa memoria." << endl;
+        return false;
+    }
+    {
+        unique_ptr<OraculoDistancias> oraculo = criarOraculoDistancias(inst.dados.g, opcoes.configOraculo, configFW,
+                                                                       reserva);
+        calcularMatrizNosChave(inst.nosChave, *oraculo);
+        if (!opcoes.arquivoMetricas.empty())
+            calcularMetricasInstancia(inst.dados.g, *oraculo, configFW, inst);
+    }
+    inst.chaveDeposito = inst.nosChave.chaveDeposito;
+    inst.noDaChave = inst.nosChave.noDaChave.data();
+    inst.distChaves = inst.nosChave.dist.visao();
+    return true;
+}
+
+// Grava o cache de uma instância preparada por calcularDistanciasInstancia (nada a fazer sem --cache ou se ela
+// veio do cache). Fica fora da resolução: no lote é chamada na etapa de escrita, fora do tempo reportado.
+// Pode ser chamada depois do construtivo: as marcas de atendido são gravadas desmarcadas.
+void gravarCacheInstanciaPreparada(const InstanciaPreparada &inst, ostream &erros)
+{
+    if (inst.caminhoCache.empty() || inst.carregadaDoCache)
+        return;
+    vector<Servico> servicos = inst.servicos;
+    for (Servico &s : servicos)
+        s.atendido = false;
+    if (!gravarCacheInstancia(inst.caminhoCache, inst.hashConteudo, inst.dados, servicos, inst.nosChave))
+        erros << "Aviso: nao foi possivel gravar o cache " << inst.caminhoCache << endl;
+}
+
+#endif // PREPARACAO_HPP
@@ -0,0 +1,266 @@
+#ifndef REOTIMIZACAO_HPP
+#define REOTIMIZACAO_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+
+#include "grafo.hpp"              // DadosInstancia, Servico
+#include "matriz_distancias.hpp"  // DIST_INF_SATURADO, ConfigFloydWarshall
+#include "oraculo_distancias.hpp" // OraculoDistancias, criarOraculoDistancias, ConfigOraculo
+#include "nos_chave.hpp"          // NosChave, construirNosChave, adicionarNoChave
+#include "preparacao.hpp"         // montarListaServicos
+#include "solucao.hpp"            // Solucao, lerSolucao, lerSolucaoBinaria, recalcularRota, recalcularSolucao
+#include "busca_local.hpp"        // BuscaLocal, ConfigBuscaLocal, CUSTO_INALCANCAVEL_BL
+
+using namespace std;
+
+// Reotimização incremental de uma solução já existente quando serviços são incluídos ou cancelados ao longo
+// do dia, sem refazer leitura, caminhos mínimos e construção:
+//   - inclusão: o serviço novo é inserido na posição e no sentido mais baratos entre as rotas com folga de
+//     capacidade (ou em uma rota nova, se nenhuma comportar a demanda). Cada rota guarda em cache a sequência
+//     de lacunas (nó-chave de saída da visita anterior, nó-chave de entrada da seguinte) e o custo de cada
+//     lacuna, então avaliar uma posição custa duas consultas à matriz entre nós-chave;
+//   - cancelamento: a visita é retirada da sua rota.
+// Em seguida a busca local repara a solução explorando de início apenas os pares que envolvem a rota alterada
+// (como após uma perturbação da ILS). Extremidades de serviços novos que ainda não são nós-chave ampliam a
+// matriz KxK com uma linha e uma coluna do oráculo de distâncias, mantido durante toda a reotimização.
+
+struct ResultadoAlteracao
+{
+    bool aplicada = false;
+    int idServico = 0;            // idGlobal do serviço incluído ou cancelado
+    long long custoAntes = 0;
+    long long custoDepois = 0;
+    long long movimentosReparo = 0; // Movimentos aplicados pela busca local de reparo
+    double segundos = 0;
+};
+
+class ReotimizacaoDinamica
+{
+public:
+    // Prepara serviços, nós-chave e oráculo de distâncias da instância. configReparo define a busca local
+    // aplicada após cada alteração (NENHUMA desativa o reparo).
+    ReotimizacaoDinamica(const DadosInstancia &dados_, const ConfigOraculo &configOraculo,
+                         const ConfigFloydWarshall &configFW, const ConfigBuscaLocal &configReparo_)
+        : dados(dados_), capacidade(dados_.capacidadeVeiculo), configReparo(configReparo_)
+    {
+        oraculo = criarOraculoDistancias(dados.g, configOraculo, configFW);
+        servicos = montarListaServicos(dados.g);
+        nos = construirNosChave(dados, servicos, *oraculo);
+    }
+
+    // Carrega uma solução gravada por escreverSolucao (sol-*.dat) ou escreverSolucaoBinaria (sol-*.bin) para os
+    // serviços da instância.
+    bool carregarSolucao(const string &nomeArquivo, ostream &erros)
+    {
+        Solucao lida;
+        const bool binaria = nomeArquivo.size() >= 4 && nomeArquivo.compare(nomeArquivo.size() - 4, 4, ".bin") == 0;
+        if (!(binaria ? lerSolucaoBinaria(nomeArquivo, servicos, lida, erros) : lerSolucao(nomeArquivo, servicos, lida, erros)))
+            return false;
+        definirSolucao(lida);
+        return true;
+    }
+
+    void definirSolucao(const Solucao &sol)
+    {
+        solucao = sol;
+        recalcularSolucao(solucao, servicos, nos.dist.visao(), nos.chaveDeposito);
+        caches.assign(solucao.rotas.size(), CacheRota());
+    }
+
+    const Solucao &solucaoAtual() const { return solucao; }
+    const vector<Servico> &listaServicos() const { return servicos; }
+
+    // Inclui um serviço novo. Do parâmetro são usados tipo, nós (idNoOriginal ou uOriginal/vOriginal),
+    // demanda e custos; o idGlobal é atribuído aqui (sequencial após o maior existente).
+    ResultadoAlteracao incluirServico(const Servico &novo)
+    {
+        auto inicio = chrono::steady_clock::now();
+        ResultadoAlteracao r;
+        r.custoAntes = solucao.custoTotal;
+        if (nos.chaveDeposito == 0 || novo.demanda <= 0 || novo.demanda > capacidade)
+            return r;
+
+        Servico s = novo;
+        if (s.tipo == Servico::Tipo::NO)
+        {
+            s.chaveU = s.chaveV = adicionarNoChave(nos, s.idNoOriginal, *oraculo);
+            s.uOriginal = s.vOriginal = 0;
+            s.p1Saida = s.p2Saida = s.idNoOriginal;
+        }
+        else
+        {
+            s.chaveU = adicionarNoChave(nos, s.uOriginal, *oraculo);
+            s.chaveV = adicionarNoChave(nos, s.vOriginal, *oraculo);
+            s.p1Saida = s.tipo == Servico::Tipo::ARCO ? s.uOriginal : 0;
+            s.p2Saida = s.tipo == Servico::Tipo::ARCO ? s.vOriginal : 0;
+        }
+        if (s.chaveU == 0 || s.chaveV == 0)
+            return r;
+        s.idGlobal = 1;
+        for (const Servico &existente : servicos)
+            s.idGlobal = max(s.idGlobal, existente.idGlobal + 1);
+        servicos.push_back(s);
+        const int idx = static_cast<int>(servicos.size()) - 1;
+
+        int rota = inserirMaisBarato(idx);
+        r.aplicada = true;
+        r.idServico = s.idGlobal;
+        r.movimentosReparo = reparar(rota);
+        r.custoDepois = solucao.custoTotal;
+        r.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        return r;
+    }
+
+    // Cancela o atendimento do serviço com o idGlobal dado (o serviço continua na lista, sem visita).
+    ResultadoAlteracao cancelarServico(int idGlobal)
+    {
+        auto inicio = chrono::steady_clock::now();
+        ResultadoAlteracao r;
+        r.custoAntes = solucao.custoTotal;
+        for (int rota = 0; rota < static_cast<int>(solucao.rotas.size()); ++rota)
+        {
+            vector<Visita> &visitas = solucao.rotas[rota].visitas;
+            for (size_t k = 0; k < visitas.size(); ++k)
+            {
+                if (servicos[visitas[k].servico].idGlobal != idGlobal)
+                    continue;
+                visitas.erase(visitas.begin() + k);
+                atualizarRota(rota);
+                if (visitas.empty())
+                {
+                    solucao.rotas.erase(solucao.rotas.begin() + rota);
+                    caches.erase(caches.begin() + rota);
+                    rota = -1;
+                }
+                r.aplicada = true;
+                r.idServico = idGlobal;
+                r.movimentosReparo = reparar(rota);
+                r.custoDepois = solucao.custoTotal;
+                r.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+                return r;
+            }
+        }
+        return r;
+    }
+
+private:
+    // Lacunas de uma rota com n visitas: para cada posição de inserção p (0..n), a chave de saída da visita
+    // anterior (ou o depósito), a chave de entrada da seguinte (ou o depósito) e a distância entre elas.
+    struct CacheRota
+    {
+        bool valido = false;
+        vector<int> anterior, seguinte;
+        vector<long long> custoLacuna;
+    };
+
+    long long d(int origem, int destino) const
+    {
+        long long v = nos.dist.linha(origem)[destino];
+        return v >= DIST_INF_SATURADO ? CUSTO_INALCANCAVEL_BL : v;
+    }
+
+    const CacheRota &cacheDaRota(int r)
+    {
+        CacheRota &c = caches[r];
+        if (c.valido)
+            return c;
+        const vector<Visita> &visitas = solucao.rotas[r].visitas;
+        const int n = static_cast<int>(visitas.size());
+        c.anterior.resize(n + 1);
+        c.seguinte.resize(n + 1);
+        c.custoLacuna.resize(n + 1);
+        for (int p = 0; p <= n; ++p)
+        {
+            c.anterior[p] = p == 0 ? nos.chaveDeposito : chaveSaida(servicos[visitas[p - 1].servico], visitas[p - 1].invertido);
+            c.seguinte[p] = p == n ? nos.chaveDeposito : chaveEntrada(servicos[visitas[p].servico], visitas[p].invertido);
+            c.custoLacuna[p] = d(c.anterior[p], c.seguinte[p]);
+        }
+        c.valido = true;
+        return c;
+    }
+
+    // Recalcula custo e demanda da rota (e o custo total) e invalida o cache de lacunas.
+    void atualizarRota(int r)
+    {
+        Rota &rota = solucao.rotas[r];
+        solucao.custoTotal -= rota.custo;
+        recalcularRota(rota, servicos, nos.dist.visao(), nos.chaveDeposito);
+        solucao.custoTotal += rota.custo;
+        caches[r].valido = false;
+    }
+
+    // Insere o serviço na posição e no sentido mais baratos entre as rotas com folga de capacidade, ou em uma
+    // rota nova. Retorna o índice da rota alterada.
+    int inserirMaisBarato(int idx)
+    {
+        const Servico &serv = servicos[idx];
+        const int numSentidos = serv.tipo == Servico::Tipo::ARESTA ? 2 : 1;
+        long long melhorCusto = 0;
+        int melhorRota = -1, melhorPos = 0;
+        bool melhorInvertido = false;
+        for (int r = 0; r < static_cast<int>(solucao.rotas.size()); ++r)
+        {
+            if (solucao.rotas[r].demanda + serv.demanda > capacidade)
+                continue; // Sem folga: a rota nem é examinada
+            const CacheRota &c = cacheDaRota(r);
+            for (int p = 0; p < static_cast<int>(c.custoLacuna.size()); ++p)
+            {
+                for (int inv = 0; inv < numSentidos; ++inv)
+                {
+                    long long custo = d(c.anterior[p], chaveEntrada(serv, inv == 1)) +
+                                      d(chaveSaida(serv, inv == 1), c.seguinte[p]) - c.custoLacuna[p];
+                    if (melhorRota == -1 || custo < melhorCusto)
+                    {
+                        melhorCusto = custo;
+                        melhorRota = r;
+                        melhorPos = p;
+                        melhorInvertido = inv == 1;
+                    }
+                }
+            }
+        }
+        if (melhorRota == -1)
+        {
+            solucao.rotas.push_back(Rota());
+            caches.push_back(CacheRota());
+            melhorRota = static_cast<int>(solucao.rotas.size()) - 1;
+            melhorInvertido = serv.tipo == Servico::Tipo::ARESTA &&
+                              d(nos.chaveDeposito, serv.chaveV) + d(serv.chaveU, nos.chaveDeposito) <
+                                  d(nos.chaveDeposito, serv.chaveU) + d(serv.chaveV, nos.chaveDeposito);
+        }
+        vector<Visita> &visitas = solucao.rotas[melhorRota].visitas;
+        visitas.insert(visitas.begin() + melhorPos, Visita{idx, melhorInvertido});
+        atualizarRota(melhorRota);
+        return melhorRota;
+    }
+
+    // Busca local a partir da rota alterada (rota < 0: só a remoção de uma rota, nada a reparar).
+    // Retorna o número de movimentos aplicados.
+    long long reparar(int rota)
+    {
+        if (rota < 0 || configReparo.modo == ModoBuscaLocal::NENHUMA)
+            return 0;
+        vector<char> alteradas(solucao.rotas.size(), 0);
+        alteradas[rota] = 1;
+        BuscaLocal buscaLocal(servicos, nos.dist.visao(), nos.chaveDeposito, capacidade, configReparo);
+        EstatisticasBuscaLocal estat = buscaLocal.otimizar(solucao, &alteradas);
+        if (estat.movimentosAplicados > 0)
+            caches.assign(solucao.rotas.size(), CacheRota()); // Rotas podem ter mudado ou sido removidas
+        return estat.movimentosAplicados;
+    }
+
+    DadosInstancia dados;
+    int capacidade;
+    ConfigBuscaLocal configReparo;
+    unique_ptr<OraculoDistancias> oraculo;
+    vector<Servico> servicos;
+    NosChave nos;
+    Solucao solucao;
+    vector<CacheRota> caches;
+};
+
+#endif // REOTIMIZACAO_HPP
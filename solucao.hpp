@@ -0,0 +1,358 @@
+#ifndef SOLUCAO_HPP
+#define SOLUCAO_HPP
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+#include "grafo.hpp"             // Servico
+#include "matriz_distancias.hpp" // VisaoMatrizDistancias, LONGLONG_INF
+#include "leitura_rapida.hpp"    // ArquivoMapeado
+#include "escrita_rapida.hpp"    // BufferSaida
+
+using namespace std;
+
+// Representação de uma solução: cada rota é uma sequência de serviços atendidos a partir do depósito.
+// Arestas podem ser atendidas nos dois sentidos (invertido = de v para u); nós e arcos têm sentido fixo.
+
+struct Visita
+{
+    int servico;            // Índice do serviço na lista de serviços da instância
+    bool invertido = false; // Para arestas: percorrida de vOriginal para uOriginal
+};
+
+struct Rota
+{
+    vector<Visita> visitas;
+    long long demanda = 0;
+    long long custo = 0; // Deslocamentos + custos de serviço, incluindo a saída e o retorno ao depósito
+};
+
+struct Solucao
+{
+    vector<Rota> rotas;
+    long long custoTotal = 0;
+};
+
+// Nó-chave onde o atendimento do serviço começa/termina.
+int chaveEntrada(const Servico &s, bool invertido)
+{
+    return (s.tipo == Servico::Tipo::ARESTA && invertido) ? s.chaveV : s.chaveU;
+}
+int chaveSaida(const Servico &s, bool invertido)
+{
+    if (s.tipo == Servico::Tipo::NO)
+        return s.chaveU;
+    return (s.tipo == Servico::Tipo::ARESTA && invertido) ? s.chaveU : s.chaveV;
+}
+
+// Nós originais de entrada/saída do serviço, usados na tupla (S id, p1, p2) do arquivo de solução.
+int noEntrada(const Servico &s, bool invertido)
+{
+    if (s.tipo == Servico::Tipo::NO)
+        return s.idNoOriginal;
+    return (s.tipo == Servico::Tipo::ARESTA && invertido) ? s.vOriginal : s.uOriginal;
+}
+int noSaida(const Servico &s, bool invertido)
+{
+    if (s.tipo == Servico::Tipo::NO)
+        return s.idNoOriginal;
+    return (s.tipo == Servico::Tipo::ARESTA && invertido) ? s.uOriginal : s.vOriginal;
+}
+
+// Custo do próprio serviço (travessia + atendimento), independente do sentido.
+long long custoAtendimento(const Servico &s)
+{
+    return static_cast<long long>(s.custoTravessia) + s.custoServicoProprio;
+}
+
+// Recalcula demanda e custo de uma rota pela matriz entre nós-chave. Retorna false se algum
+// deslocamento da rota for impossível (nesse caso o custo não inclui esse deslocamento).
+bool recalcularRota(Rota &rota, const vector<Servico> &servicos, VisaoMatrizDistancias dist, int chaveDeposito)
+{
+    bool alcancavel = true;
+    int chaveAtual = chaveDeposito;
+    rota.demanda = 0;
+    rota.custo = 0;
+    auto deslocar = [&](int destino)
+    {
+        long long d = (chaveAtual > 0 && destino > 0) ? dist(chaveAtual, destino) : LONGLONG_INF;
+        if (d == LONGLONG_INF)
+            alcancavel = false;
+        else
+            rota.custo += d;
+        chaveAtual = destino;
+    };
+    for (const Visita &v : rota.visitas)
+    {
+        const Servico &s = servicos[v.servico];
+        deslocar(chaveEntrada(s, v.invertido));
+        rota.custo += custoAtendimento(s);
+        rota.demanda += s.demanda;
+        chaveAtual = chaveSaida(s, v.invertido);
+    }
+    if (!rota.visitas.empty())
+        deslocar(chaveDeposito);
+    return alcancavel;
+}
+
+// Recalcula todas as rotas e o custo total (por exemplo, após uma mudança na matriz de distâncias).
+// Retorna false se alguma rota ficou com um deslocamento impossível.
+bool recalcularSolucao(Solucao &sol, const vector<Servico> &servicos, VisaoMatrizDistancias dist, int chaveDeposito)
+{
+    bool alcancavel = true;
+    sol.custoTotal = 0;
+    for (Rota &rota : sol.rotas)
+    {
+        if (!recalcularRota(rota, servicos, dist, chaveDeposito))
+            alcancavel = false;
+        sol.custoTotal += rota.custo;
+    }
+    return alcancavel;
+}
+
+// Linha de uma rota no formato do arquivo de solução (sem o fim de linha), acrescentada ao buffer:
+// "0 1 id demanda custo num_visitas (D 0,1,1) (S id,p1,p2) ... (D 0,1,1)".
+void formatarRota(const Rota &rota, int idRota, const vector<Servico> &servicos, BufferSaida &buffer)
+{
+    buffer.texto("0 1 ");
+    buffer.inteiro(idRota);
+    buffer.caractere(' ');
+    buffer.inteiro(rota.demanda);
+    buffer.caractere(' ');
+    buffer.inteiro(rota.custo);
+    buffer.caractere(' ');
+    buffer.inteiro(rota.visitas.size() + 2);
+    buffer.texto(" (D 0,1,1)");
+    for (const Visita &v : rota.visitas)
+    {
+        const Servico &s = servicos[v.servico];
+        buffer.texto(" (S ");
+        buffer.inteiro(s.idGlobal);
+        buffer.caractere(',');
+        buffer.inteiro(noEntrada(s, v.invertido));
+        buffer.caractere(',');
+        buffer.inteiro(noSaida(s, v.invertido));
+        buffer.caractere(')');
+    }
+    buffer.texto(" (D 0,1,1)");
+}
+
+// Grava o arquivo de solução: custo total, número de rotas, tempo total e tempo até a melhor solução
+// (em microssegundos) e uma linha por rota. Rotas vazias são omitidas. O arquivo é montado em buffer
+// (reaproveitado entre chamadas) e gravado de uma vez. Retorna false se não conseguir gravar.
+bool escreverSolucao(const string &nomeArquivoSaida, const Solucao &solucao, const vector<Servico> &servicos,
+                     long long clocksTotal, long long clocksMelhor, BufferSaida &buffer)
+{
+    int numRotas = 0;
+    for (const Rota &r : solucao.rotas)
+        numRotas += !r.visitas.empty();
+    buffer.limpar();
+    for (long long valor : {solucao.custoTotal, static_cast<long long>(numRotas), clocksTotal, clocksMelhor})
+    {
+        buffer.inteiro(valor);
+        buffer.caractere('\n');
+    }
+    int idRota = 1;
+    for (const Rota &r : solucao.rotas)
+    {
+        if (r.visitas.empty())
+            continue;
+        formatarRota(r, idRota++, servicos, buffer);
+        buffer.caractere('\n');
+    }
+    return buffer.gravar(nomeArquivoSaida);
+}
+
+// Formato binário compacto da solução (sol-*.bin), para ferramentas que consomem as soluções sem parsing de
+// texto. Mesmo conteúdo do sol-*.dat, em inteiros na ordem de bytes da máquina: o cabeçalho, e para cada rota
+// não vazia um RegistroRotaBinaria seguido de numVisitas registros (idGlobal, p1, p2).
+const char MAGICA_SOLUCAO[8] = {'M', 'C', 'G', 'R', 'P', 'S', 'O', 'L'};
+const uint32_t VERSAO_SOLUCAO_BINARIA = 1;
+
+struct CabecalhoSolucaoBinaria
+{
+    char magica[8];
+    uint32_t versao;
+    uint32_t numRotas;
+    int64_t custoTotal;
+    int64_t clocksTotal, clocksMelhor; // Microssegundos, como no arquivo de texto
+};
+
+struct RegistroRotaBinaria
+{
+    int64_t demanda;
+    int64_t custo;
+    uint32_t numVisitas;
+    uint32_t reservado;
+};
+
+struct VisitaBinaria
+{
+    int32_t idServico, p1, p2;
+};
+
+bool escreverSolucaoBinaria(const string &nomeArquivoSaida, const Solucao &solucao, const vector<Servico> &servicos,
+                            long long clocksTotal, long long clocksMelhor, BufferSaida &buffer)
+{
+    CabecalhoSolucaoBinaria cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_SOLUCAO, sizeof(cab.magica));
+    cab.versao = VERSAO_SOLUCAO_BINARIA;
+    for (const Rota &r : solucao.rotas)
+        cab.numRotas += !r.visitas.empty();
+    cab.custoTotal = solucao.custoTotal;
+    cab.clocksTotal = clocksTotal;
+    cab.clocksMelhor = clocksMelhor;
+
+    buffer.limpar();
+    buffer.binario(cab);
+    for (const Rota &r : solucao.rotas)
+    {
+        if (r.visitas.empty())
+            continue;
+        buffer.binario(RegistroRotaBinaria{r.demanda, r.custo, static_cast<uint32_t>(r.visitas.size()), 0});
+        for (const Visita &v : r.visitas)
+        {
+            const Servico &s = servicos[v.servico];
+            buffer.binario(VisitaBinaria{s.idGlobal, noEntrada(s, v.invertido), noSaida(s, v.invertido)});
+        }
+    }
+    return buffer.gravar(nomeArquivoSaida);
+}
+
+// Índice na lista de serviços de cada idGlobal (-1 se não existir).
+vector<int> indicePorIdGlobal(const vector<Servico> &servicos)
+{
+    vector<int> indiceDoId;
+    for (size_t i = 0; i < servicos.size(); ++i)
+    {
+        if (servicos[i].idGlobal >= static_cast<int>(indiceDoId.size()))
+            indiceDoId.resize(servicos[i].idGlobal + 1, -1);
+        indiceDoId[servicos[i].idGlobal] = static_cast<int>(i);
+    }
+    return indiceDoId;
+}
+
+// Visita ao serviço que começa no nó original p1 (arestas atendidas de vOriginal para uOriginal são invertidas).
+Visita visitaPorNoEntrada(int idx, const Servico &s, int p1)
+{
+    return {idx, s.tipo == Servico::Tipo::ARESTA && p1 == s.vOriginal && p1 != s.uOriginal};
+}
+
+// Lê um arquivo de solução no formato de escreverSolucao. Os serviços são identificados pelo idGlobal e o
+// sentido de atendimento das arestas pelo nó de entrada p1. As quatro linhas de cabeçalho são ignoradas:
+// demanda e custo das rotas devem ser recalculados depois (recalcularSolucao). Retorna false (após escrever
+// o erro) se o arquivo não abrir ou tiver um serviço desconhecido ou repetido.
+bool lerSolucao(const string &nomeArquivo, const vector<Servico> &servicos, Solucao &solucao, ostream &erros)
+{
+    ifstream arq(nomeArquivo);
+    if (!arq.is_open())
+    {
+        erros << "Erro ao abrir arquivo de solucao: " << nomeArquivo << endl;
+        return false;
+    }
+    const vector<int> indiceDoId = indicePorIdGlobal(servicos);
+    vector<char> visitado(servicos.size(), 0);
+
+    solucao = Solucao();
+    string linha;
+    int numLinha = 0;
+    while (getline(arq, linha))
+    {
+        if (++numLinha <= 4 || linha.find("(D") == string::npos)
+            continue; // Custo total, número de rotas e tempos
+        Rota rota;
+        for (size_t pos = linha.find("(S "); pos != string::npos; pos = linha.find("(S ", pos + 3))
+        {
+            // Tupla "(S id,p1,p2)"
+            int campos[3];
+            const char *p = linha.data() + pos + 3, *fim = linha.data() + linha.size();
+            bool ok = true;
+            for (int c = 0; c < 3 && ok; ++c)
+            {
+                auto [prox, erro] = from_chars(p, fim, campos[c]);
+                ok = erro == errc() && prox < fim && *prox == (c < 2 ? ',' : ')');
+                p = prox + 1;
+            }
+            const int id = campos[0];
+            const int idx = ok && id > 0 && id < static_cast<int>(indiceDoId.size()) ? indiceDoId[id] : -1;
+            if (idx < 0 || visitado[idx])
+            {
+                erros << "Servico invalido ou repetido na linha " << numLinha << " de " << nomeArquivo << endl;
+                return false;
+            }
+            visitado[idx] = 1;
+            rota.visitas.push_back(visitaPorNoEntrada(idx, servicos[idx], campos[1]));
+        }
+        solucao.rotas.push_back(std::move(rota));
+    }
+    return true;
+}
+
+// Lê um arquivo no formato de escreverSolucaoBinaria (mapeado em memória). Demanda e custo das rotas e o custo
+// total vêm do arquivo. Retorna false (após escrever o erro) se o arquivo não abrir, estiver truncado, for de
+// outra versão ou tiver um serviço desconhecido ou repetido.
+bool lerSolucaoBinaria(const string &nomeArquivo, const vector<Servico> &servicos, Solucao &solucao, ostream &erros)
+{
+    ArquivoMapeado arquivo(nomeArquivo);
+    if (!arquivo.estaAberto())
+    {
+        erros << "Erro ao abrir arquivo de solucao: " << nomeArquivo << endl;
+        return false;
+    }
+    const char *p = arquivo.dados(), *fim = arquivo.dados() + arquivo.tamanho();
+    auto ler = [&](auto &destino)
+    {
+        if (static_cast<size_t>(fim - p) < sizeof(destino))
+            return false;
+        memcpy(&destino, p, sizeof(destino));
+        p += sizeof(destino);
+        return true;
+    };
+    CabecalhoSolucaoBinaria cab;
+    if (!ler(cab) || memcmp(cab.magica, MAGICA_SOLUCAO, sizeof(cab.magica)) != 0 || cab.versao != VERSAO_SOLUCAO_BINARIA ||
+        static_cast<size_t>(fim - p) / sizeof(RegistroRotaBinaria) < cab.numRotas)
+    {
+        erros << "Arquivo de solucao binaria invalido: " << nomeArquivo << endl;
+        return false;
+    }
+
+    const vector<int> indiceDoId = indicePorIdGlobal(servicos);
+    vector<char> visitado(servicos.size(), 0);
+    solucao = Solucao();
+    solucao.custoTotal = cab.custoTotal;
+    solucao.rotas.resize(cab.numRotas);
+    for (Rota &rota : solucao.rotas)
+    {
+        RegistroRotaBinaria reg;
+        if (!ler(reg) || static_cast<size_t>(fim - p) / sizeof(VisitaBinaria) < reg.numVisitas)
+        {
+            erros << "Arquivo de solucao binaria truncado: " << nomeArquivo << endl;
+            return false;
+        }
+        rota.demanda = reg.demanda;
+        rota.custo = reg.custo;
+        rota.visitas.reserve(reg.numVisitas);
+        for (uint32_t k = 0; k < reg.numVisitas; ++k)
+        {
+            VisitaBinaria v;
+            ler(v);
+            const int idx = v.idServico > 0 && v.idServico < static_cast<int>(indiceDoId.size()) ? indiceDoId[v.idServico] : -1;
+            if (idx < 0 || visitado[idx])
+            {
+                erros << "Servico invalido ou repetido (id " << v.idServico << ") em " << nomeArquivo << endl;
+                return false;
+            }
+            visitado[idx] = 1;
+            rota.visitas.push_back(visitaPorNoEntrada(idx, servicos[idx], v.p1));
+        }
+    }
+    return true;
+}
+
+#endif // SOLUCAO_HPP
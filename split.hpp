@@ -0,0 +1,149 @@
+#ifndef SPLIT_HPP
+#define SPLIT_HPP
+
+#include <iostream>
+#include <vector>
+#include <climits>
+
+#include "grafo.hpp"             // Servico
+#include "matriz_distancias.hpp" // VisaoMatrizDistancias, DIST_INF_SATURADO
+#include "preparacao.hpp"        // InstanciaPreparada
+#include "candidatos.hpp"        // IndiceCandidatos, AvaliacaoServico
+#include "solucao.hpp"           // Solucao, Rota, Visita
+#include "busca_local.hpp"       // CUSTO_INALCANCAVEL_BL
+
+using namespace std;
+
+// Construtivo "rota primeiro, agrupamento depois": uma rota gigante com todos os serviços (vizinho mais
+// próximo sem limite de capacidade, escolhendo o sentido das arestas durante a construção) é dividida de
+// forma ótima em rotas que respeitam a capacidade pelo Split linear: com a ordem e os sentidos fixos, o custo
+// de uma rota com os serviços i+1..j é V(i) + g(j), e a melhor divisão é um mínimo em janela deslizante
+// (a janela são os i cuja carga até j cabe no veículo), mantido em uma fila dupla monotônica em O(n).
+
+// Rota gigante pelo vizinho mais próximo a partir do depósito, usando o índice de candidatos do construtivo.
+// Serviços inalcançáveis ou maiores que o veículo ficam de fora.
+vector<Visita> montarRotaGigante(InstanciaPreparada &inst, int tamanhoListaCandidatos)
+{
+    vector<Visita> rotaGigante;
+    rotaGigante.reserve(inst.servicos.size());
+    IndiceCandidatos indice(inst.servicos, inst.distChaves, inst.capacidadeVeiculo, tamanhoListaCandidatos);
+    int chavePos = inst.chaveDeposito;
+    AvaliacaoServico aval;
+    for (int i = indice.melhorServico(chavePos, LLONG_MAX, aval); i != -1; i = indice.melhorServico(chavePos, LLONG_MAX, aval))
+    {
+        indice.marcarAtendido(i);
+        rotaGigante.push_back({i, aval.invertido});
+        chavePos = aval.chavePosFinal;
+    }
+    return rotaGigante;
+}
+
+// Divide a rota gigante (ordem e sentidos fixos) no conjunto de rotas de menor custo total que respeita a
+// capacidade. Retorna false se algum serviço não couber sozinho no veículo.
+bool dividirRotaGigante(const vector<Visita> &rotaGigante, const vector<Servico> &servicos, VisaoMatrizDistancias dist,
+                        int chaveDeposito, long long capacidade, Solucao &solucao)
+{
+    const int n = static_cast<int>(rotaGigante.size());
+    auto d = [&](int origem, int destino)
+    {
+        long long v = dist.linha(origem)[destino];
+        return v >= DIST_INF_SATURADO ? CUSTO_INALCANCAVEL_BL : v;
+    };
+
+    // Posições 1..n. deposito[k]/retorno[k]: deslocamentos depósito -> k e k -> depósito;
+    // conexoes[k]: deslocamentos internos de 1 até k; carga[k]: demanda de 1 até k.
+    vector<long long> deposito(n + 2, 0), retorno(n + 1, 0), conexoes(n + 2, 0), carga(n + 1, 0);
+    for (int k = 1; k <= n; ++k)
+    {
+        const Servico &s = servicos[rotaGigante[k - 1].servico];
+        const bool inv = rotaGigante[k - 1].invertido;
+        deposito[k] = d(chaveDeposito, chaveEntrada(s, inv));
+        retorno[k] = d(chaveSaida(s, inv), chaveDeposito);
+        carga[k] = carga[k - 1] + s.demanda;
+        if (k > 1)
+        {
+            const Servico &anterior = servicos[rotaGigante[k - 2].servico];
+            conexoes[k] = conexoes[k - 1] + d(chaveSaida(anterior, rotaGigante[k - 2].invertido), chaveEntrada(s, inv));
+        }
+    }
+
+    // potencial[j]: menor custo de deslocamentos para atender 1..j; V(i) = potencial[i] + deposito[i+1] - conexoes[i+1]
+    vector<long long> potencial(n + 1, LLONG_MAX);
+    vector<int> predecessor(n + 1, -1);
+    vector<int> fila(n + 1); // Fila dupla em um vetor: V crescente da frente para o fim
+    int frente = 0, fim = 0;
+    auto valor = [&](int i)
+    { return potencial[i] + deposito[i + 1] - conexoes[i + 1]; };
+
+    potencial[0] = 0;
+    fila[fim++] = 0;
+    for (int j = 1; j <= n; ++j)
+    {
+        while (frente < fim && carga[j] - carga[fila[frente]] > capacidade)
+            frente++;
+        if (frente == fim)
+            return false; // O serviço j não cabe sozinho no veículo
+        const int i = fila[frente];
+        potencial[j] = valor(i) + conexoes[j] + retorno[j];
+        predecessor[j] = i;
+        if (j < n)
+        {
+            while (fim > frente && valor(fila[fim - 1]) >= valor(j))
+                fim--;
+            fila[fim++] = j;
+        }
+    }
+
+    // Reconstrói as rotas a partir dos predecessores
+    solucao.rotas.clear();
+    solucao.custoTotal = 0;
+    for (int j = n; j > 0; j = predecessor[j])
+    {
+        Rota rota;
+        rota.visitas.assign(rotaGigante.begin() + predecessor[j], rotaGigante.begin() + j);
+        solucao.rotas.push_back(std::move(rota));
+    }
+    reverse(solucao.rotas.begin(), solucao.rotas.end());
+    for (Rota &r : solucao.rotas)
+    {
+        recalcularRota(r, servicos, dist, chaveDeposito);
+        solucao.custoTotal += r.custo;
+    }
+    return true;
+}
+
+// Construtivo por rota gigante + Split. Marca os serviços atendidos em inst.servicos. Alertas vão para saida.
+Solucao construirSolucaoSplit(InstanciaPreparada &inst, int tamanhoListaCandidatos, ostream &saida, ostream &erros)
+{
+    Solucao solucao;
+    const int totalServicosRequeridos = inst.servicos.size();
+    if (totalServicosRequeridos == 0)
+    {
+        saida << "Instancia " << inst.nomeInstancia << " nao possui servicos requeridos." << endl;
+        return solucao;
+    }
+
+    vector<Visita> rotaGigante = montarRotaGigante(inst, tamanhoListaCandidatos);
+    if (!dividirRotaGigante(rotaGigante, inst.servicos, inst.distChaves, inst.chaveDeposito, inst.capacidadeVeiculo, solucao))
+    {
+        erros << "Erro: Split sem divisao viavel para " << inst.nomeInstancia << "." << endl;
+        return Solucao();
+    }
+    for (const Rota &r : solucao.rotas)
+    {
+        if (inst.distChaves(inst.chaveDeposito, chaveEntrada(inst.servicos[r.visitas.front().servico], r.visitas.front().invertido)) == LONGLONG_INF ||
+            inst.distChaves(chaveSaida(inst.servicos[r.visitas.back().servico], r.visitas.back().invertido), inst.chaveDeposito) == LONGLONG_INF)
+        {
+            erros << "ALERTA: Rota do Split para " << inst.nomeInstancia << " nao pode sair ou retornar ao deposito." << endl;
+        }
+    }
+
+    if (static_cast<int>(rotaGigante.size()) < totalServicosRequeridos)
+    {
+        saida << "Alerta Final: Para " << inst.nomeInstancia << ", nem todos os servicos foram atendidos. "
+              << "Atendidos: " << rotaGigante.size() << "/" << totalServicosRequeridos << endl;
+    }
+    return solucao;
+}
+
+#endif // SPLIT_HPP
@@ -0,0 +1,625 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <filesystem>
+#include <random>
+#include <cstdint>
+#include <cstring>
+
+#include "grafo.hpp"               // DadosInstancia
+#include "leitura_rapida.hpp"      // lerInstanciaDeMemoria
+#include "fonte_instancias.hpp"    // abrirFonteInstancias
+#include "descompactacao.hpp"      // descompactarDeflate
+#include "preparacao.hpp"          // lerInstancia, InstanciaPreparada
+#include "cache_instancias.hpp"    // CabecalhoCache
+#include "opcoes.hpp"              // OpcoesExecucao
+#include "funcoes.hpp"             // floydWarshall
+#include "nos_chave.hpp"           // construirNosChave
+#include "distancias_dinamicas.hpp" // DistanciasDinamicas
+#include "construtivo.hpp"         // construirSolucaoGulosa
+#include "solucao.hpp"             // escreverSolucao, noEntrada, noSaida
+#include "reotimizacao.hpp"        // ReotimizacaoDinamica
+#include "gerador_instancias.hpp"  // gerarInstancia, escreverInstancia
+
+using namespace std;
+
+// Verificações de regressão, sem dependências externas. Cada verificação monta os próprios dados (instâncias
+// sintéticas do gerador_instancias.hpp ou, com --instancias, as de uma pasta/.zip), compara o resultado com
+// uma referência calculada de outra forma e imprime OK ou FALHA com o motivo. O código de saída é 1 se alguma
+// verificação falhar.
+// Compilação: g++ -std=c++17 -O2 -march=native verificacao.cpp -o verificacao -pthread
+
+struct OpcoesVerificacao
+{
+    string pastaTemporaria = (std::filesystem::temp_directory_path() / "verificacao-mcgrp").string();
+    unsigned long long semente = 1;
+    int operacoes = 300; // Alterações sorteadas nas verificações incrementais
+    string instancias;   // Pasta ou .zip para a reotimização (vazio = instâncias sintéticas)
+    int alteracoesPorInstancia = 10;
+};
+
+// Resultado de uma verificação: vazio se passou, ou a descrição da primeira divergência.
+using Verificacao = function<string(const OpcoesVerificacao &)>;
+
+string lerArquivoTexto(const string &nomeArquivo)
+{
+    ifstream arq(nomeArquivo, ios::binary);
+    return string(istreambuf_iterator<char>(arq), istreambuf_iterator<char>());
+}
+
+// Leitura com a mesma InstanciaPreparada (como as áreas recicladas do pipeline do modo em lote): um arquivo
+// sem a linha "#Nodes:" lido depois de uma instância válida deve ser rejeitado, como quando lido sozinho, em
+// vez de herdar o grafo anterior; e reler a instância válida deve dar o mesmo grafo que uma leitura nova.
+string verificarLeituraReaproveitada(const OpcoesVerificacao &opcoes)
+{
+    namespace fs = std::filesystem;
+    const string pasta = (fs::path(opcoes.pastaTemporaria) / "leitura").string();
+    fs::remove_all(pasta);
+    fs::create_directories(pasta);
+
+    ConfigGerador config;
+    config.numNos = 200;
+    config.semente = opcoes.semente;
+    const string arqValida = (fs::path(pasta) / "a-valida.dat").string();
+    if (!escreverInstancia(arqValida, gerarInstancia(config, "a-valida")))
+        return "nao foi possivel gravar " + arqValida;
+    istringstream texto(lerArquivoTexto(arqValida));
+    ofstream semNos((fs::path(pasta) / "b-sem-nodes.dat").string());
+    string linha;
+    while (getline(texto, linha))
+    {
+        if (linha.rfind("#Nodes:", 0) != 0)
+            semNos << linha << "\n";
+    }
+    semNos.close();
+
+    for (bool mapeada : {true, false})
+    {
+        const string leitor = mapeada ? "mmap" : "fluxo";
+        unique_ptr<FonteInstancias> fonte = abrirFonteInstancias(pasta, mapeada, cerr);
+        if (!fonte || fonte->quantidade() != 2)
+            return "pasta de teste nao encontrada: " + pasta;
+        OpcoesExecucao opcoesExecucao;
+        opcoesExecucao.leituraMapeada = mapeada;
+        ostringstream erros;
+        InstanciaPreparada referencia, reciclada;
+        if (!lerInstancia(*fonte, 0, opcoesExecucao, referencia, erros))
+            return "instancia valida rejeitada (" + leitor + ")";
+        if (lerInstancia(*fonte, 1, opcoesExecucao, reciclada, erros))
+            return "arquivo sem #Nodes aceito sozinho (" + leitor + ")";
+        for (int repeticao = 0; repeticao < 2; ++repeticao)
+        {
+            if (!lerInstancia(*fonte, 0, opcoesExecucao, reciclada, erros))
+                return "instancia valida rejeitada na area reciclada (" + leitor + ")";
+            const Grafo &g = reciclada.dados.g, &r = referencia.dados.g;
+            if (g.V != r.V || g.vertices.size() != r.vertices.size() || g.arestas.size() != r.arestas.size() ||
+                g.arcos.size() != r.arcos.size() || g.adjacencia.sucessores.size() != r.adjacencia.sucessores.size())
+                return "releitura na area reciclada difere da leitura nova (" + leitor + ")";
+            if (lerInstancia(*fonte, 1, opcoesExecucao, reciclada, erros))
+                return "arquivo sem #Nodes aceito depois de uma instancia valida (" + leitor + ")";
+        }
+    }
+    fs::remove_all(pasta);
+    return "";
+}
+
+// Nó requerido com identificador malformado ("N4x"): o leitor mapeado não pode aceitá-lo como o nó 4.
+string verificarTokenNoMalformado(const OpcoesVerificacao &opcoes)
+{
+    ConfigGerador config;
+    config.numNos = 60;
+    config.semente = opcoes.semente;
+    const string arquivo = (std::filesystem::path(opcoes.pastaTemporaria) / "no-malformado.dat").string();
+    std::filesystem::create_directories(opcoes.pastaTemporaria);
+    if (!escreverInstancia(arquivo, gerarInstancia(config, "no-malformado")))
+        return "nao foi possivel gravar " + arquivo;
+    string texto = lerArquivoTexto(arquivo);
+    std::filesystem::remove(arquivo);
+    const size_t secao = texto.find("ReN.");
+    const size_t inicio = secao == string::npos ? secao : texto.find("\nN", secao);
+    if (inicio == string::npos)
+        return "instancia sintetica sem nos requeridos";
+    const size_t fim = texto.find('\t', inicio);
+    const int idNo = stoi(texto.substr(inicio + 2, fim - inicio - 2));
+    texto.insert(fim, "x");
+
+    DadosInstancia dados;
+    lerInstanciaDeMemoria(texto, "no-malformado", dados);
+    for (const Vertice &v : dados.g.vertices)
+    {
+        if (v.id == idNo)
+            return "N" + to_string(idNo) + "x aceito como o no " + to_string(idNo);
+    }
+    return "";
+}
+
+// Distância normalizada para comparação (o sentinela de infinito pode diferir entre matrizes).
+long long distanciaNormalizada(long long d)
+{
+    return d >= DIST_INF_SATURADO ? LONGLONG_INF : d;
+}
+
+// Caminhos mínimos incrementais (DistanciasDinamicas): após cada alteração sorteada (redução ou aumento de
+// custo, ligação nova ou removida, em arestas e arcos) a matriz mantida deve ser igual a um Floyd-Warshall
+// completo do grafo alterado. No fim, a matriz entre nós-chave e os custos dos serviços atualizados devem ser
+// iguais aos reconstruídos do zero.
+string verificarDistanciasDinamicas(const OpcoesVerificacao &opcoes)
+{
+    ConfigGerador config;
+    config.numNos = 150;
+    config.semente = opcoes.semente;
+    DadosInstancia dados = gerarInstancia(config, "dinamica");
+    DistanciasDinamicas dinamica(dados.g);
+    mt19937_64 gerador(opcoes.semente);
+    auto sortear = [&](int n)
+    { return static_cast<int>(gerador() % static_cast<unsigned long long>(n)); };
+
+    int aplicadas = 0;
+    for (int op = 0; op < opcoes.operacoes; ++op)
+    {
+        const Grafo &g = dinamica.grafo();
+        const bool aresta = g.arcos.empty() || (!g.arestas.empty() && sortear(2) == 0);
+        const TipoLigacao tipo = aresta ? TipoLigacao::ARESTA : TipoLigacao::ARCO;
+        const int k = sortear(static_cast<int>(aresta ? g.arestas.size() : g.arcos.size()));
+        const int origem = aresta ? g.arestas[k].origem : g.arcos[k].origem;
+        const int destino = aresta ? g.arestas[k].destino : g.arcos[k].destino;
+        ResultadoAtualizacao r;
+        switch (sortear(4))
+        {
+        case 0:
+            r = dinamica.alterarCusto(tipo, origem, destino, sortear(5)); // Redução (quase sempre)
+            break;
+        case 1:
+            r = dinamica.alterarCusto(tipo, origem, destino, 50 + sortear(200)); // Aumento (quase sempre)
+            break;
+        case 2:
+            r = dinamica.adicionarLigacao(tipo, 1 + sortear(g.V), 1 + sortear(g.V), sortear(100));
+            break;
+        default:
+            r = dinamica.removerLigacao(tipo, origem, destino); // Recusada para ligações requeridas
+            break;
+        }
+        aplicadas += r.aplicada;
+
+        const MatrizDistancias referencia = floydWarshall(dinamica.grafo());
+        const MatrizDistancias &atual = dinamica.matriz();
+        for (int i = 1; i <= g.V; ++i)
+        {
+            for (int j = 1; j <= g.V; ++j)
+            {
+                if (distanciaNormalizada(atual(i, j)) != distanciaNormalizada(referencia(i, j)))
+                    return "operacao " + to_string(op) + ": d(" + to_string(i) + "," + to_string(j) + ") = " +
+                           to_string(atual(i, j)) + ", Floyd-Warshall = " + to_string(referencia(i, j));
+            }
+        }
+    }
+    if (aplicadas == 0)
+        return "nenhuma alteracao foi aplicada";
+
+    // Nós-chave e custos dos serviços: atualização incremental x reconstrução sobre o grafo alterado
+    vector<Servico> servicos = montarListaServicos(dados.g);
+    unique_ptr<OraculoDistancias> oraculo = criarOraculoDistancias(dados.g, ConfigOraculo(), ConfigFloydWarshall());
+    NosChave nos = construirNosChave(dados, servicos, *oraculo);
+    dinamica.atualizarNosChave(nos);
+    dinamica.atualizarCustosServicos(servicos);
+
+    DadosInstancia alterada = dados;
+    alterada.g = dinamica.grafo();
+    vector<Servico> servicosRef = montarListaServicos(alterada.g);
+    unique_ptr<OraculoDistancias> oraculoRef = criarOraculoDistancias(alterada.g, ConfigOraculo(), ConfigFloydWarshall());
+    NosChave nosRef = construirNosChave(alterada, servicosRef, *oraculoRef);
+    if (nos.numChaves() != nosRef.numChaves() || servicos.size() != servicosRef.size())
+        return "nos-chave ou servicos diferentes da reconstrucao";
+    for (size_t s = 0; s < servicos.size(); ++s)
+    {
+        if (servicos[s].custoTravessia != servicosRef[s].custoTravessia)
+            return "custo do servico " + to_string(servicos[s].idGlobal) + " diferente da reconstrucao";
+    }
+    for (int x = 1; x <= nos.numChaves(); ++x)
+    {
+        for (int y = 1; y <= nos.numChaves(); ++y)
+        {
+            if (distanciaNormalizada(nos.dist(x, y)) != distanciaNormalizada(nosRef.dist(x, y)))
+                return "matriz entre nos-chave diferente da reconstrucao em (" + to_string(x) + "," + to_string(y) + ")";
+        }
+    }
+    return "";
+}
+
+// Confere a solução da reotimização contra uma matriz completa calculada à parte: cada serviço ativo atendido
+// exatamente uma vez (e os cancelados nenhuma), capacidade respeitada e demanda, custo de cada rota e custo
+// total iguais aos recalculados pelos nós originais. Retorna a primeira divergência (vazio se nenhuma).
+string conferirSolucaoReotimizada(const ReotimizacaoDinamica &reotimizacao, const DadosInstancia &dados,
+                                  const MatrizDistancias &dist, const vector<char> &ativo)
+{
+    const vector<Servico> &servicos = reotimizacao.listaServicos();
+    const Solucao &sol = reotimizacao.solucaoAtual();
+    vector<int> atendimentos(servicos.size(), 0);
+    long long custoTotal = 0;
+    for (size_t r = 0; r < sol.rotas.size(); ++r)
+    {
+        const Rota &rota = sol.rotas[r];
+        long long demanda = 0, custo = 0;
+        int noAtual = dados.idNoDeposito;
+        auto deslocar = [&](int destino)
+        {
+            if (dist(noAtual, destino) >= DIST_INF_SATURADO)
+                return false;
+            custo += dist(noAtual, destino);
+            return true;
+        };
+        for (const Visita &v : rota.visitas)
+        {
+            const Servico &s = servicos[v.servico];
+            atendimentos[v.servico]++;
+            if (!deslocar(noEntrada(s, v.invertido)))
+                return "rota " + to_string(r) + " com deslocamento impossivel";
+            custo += custoAtendimento(s);
+            demanda += s.demanda;
+            noAtual = noSaida(s, v.invertido);
+        }
+        if (!rota.visitas.empty() && !deslocar(dados.idNoDeposito))
+            return "rota " + to_string(r) + " sem retorno ao deposito";
+        if (demanda > dados.capacidadeVeiculo)
+            return "rota " + to_string(r) + " excede a capacidade";
+        if (demanda != rota.demanda || custo != rota.custo)
+            return "rota " + to_string(r) + ": demanda/custo " + to_string(rota.demanda) + "/" + to_string(rota.custo) +
+                   ", recalculados " + to_string(demanda) + "/" + to_string(custo);
+        custoTotal += custo;
+    }
+    if (custoTotal != sol.custoTotal)
+        return "custo total " + to_string(sol.custoTotal) + ", recalculado " + to_string(custoTotal);
+    for (size_t i = 0; i < servicos.size(); ++i)
+    {
+        const int esperado = i < ativo.size() && ativo[i] ? 1 : 0;
+        if (atendimentos[i] != esperado)
+            return "servico " + to_string(servicos[i].idGlobal) + " atendido " + to_string(atendimentos[i]) + " vezes";
+    }
+    return "";
+}
+
+// Diretório central de .zip com comprimento de nome além do fim do arquivo: o arquivo íntegro abre com um
+// membro, e a mesma entrada com o campo de nome adulterado precisa ser rejeitada antes de ler o nome.
+string verificarZipCorrompido(const OpcoesVerificacao &opcoes)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(opcoes.pastaTemporaria);
+    const string nome = "a.dat", conteudo = "NAME : zip\n";
+    auto montarZip = [&](uint16_t tamNomeCentral)
+    {
+        string zip;
+        auto u16 = [&](uint16_t v)
+        { zip += static_cast<char>(v & 0xFF), zip += static_cast<char>(v >> 8); };
+        auto u32 = [&](uint32_t v)
+        { u16(static_cast<uint16_t>(v & 0xFFFF)), u16(static_cast<uint16_t>(v >> 16)); };
+        // Cabeçalho local e dados armazenados (o CRC não é conferido na leitura do diretório)
+        u32(0x04034b50), u16(10), u16(0), u16(0), u16(0), u16(0), u32(0);
+        u32(static_cast<uint32_t>(conteudo.size())), u32(static_cast<uint32_t>(conteudo.size()));
+        u16(static_cast<uint16_t>(nome.size())), u16(0);
+        zip += nome + conteudo;
+        const uint32_t inicioCentral = static_cast<uint32_t>(zip.size());
+        u32(0x02014b50), u16(20), u16(10), u16(0), u16(0), u16(0), u16(0), u32(0);
+        u32(static_cast<uint32_t>(conteudo.size())), u32(static_cast<uint32_t>(conteudo.size()));
+        u16(tamNomeCentral), u16(0), u16(0), u16(0), u16(0), u32(0), u32(0);
+        zip += nome;
+        const uint32_t tamCentral = static_cast<uint32_t>(zip.size()) - inicioCentral;
+        u32(0x06054b50), u16(0), u16(0), u16(1), u16(1), u32(tamCentral), u32(inicioCentral), u16(0);
+        return zip;
+    };
+    const string arquivo = (fs::path(opcoes.pastaTemporaria) / "diretorio-central.zip").string();
+    for (uint16_t tamNome : {static_cast<uint16_t>(nome.size()), static_cast<uint16_t>(60000)})
+    {
+        ofstream(arquivo, ios::binary) << montarZip(tamNome);
+        FonteZip fonte(arquivo);
+        const bool integro = tamNome == nome.size();
+        if (integro && (!fonte.valida() || fonte.quantidade() != 1))
+            return "zip integro rejeitado: " + fonte.mensagemErro();
+        if (!integro && fonte.valida())
+            return "nome do diretorio central alem do fim do arquivo aceito";
+    }
+    fs::remove(arquivo);
+    return "";
+}
+
+// Membro DEFLATE cujo tamanho declarado não confere com os dados: com o tamanho certo a descompactação
+// funciona; com um tamanho menor ela é interrompida no limite, e com 4 GB declarados a reserva fica limitada
+// e o membro é rejeitado por vir menor que o declarado.
+string verificarDescompactacaoLimitada(const OpcoesVerificacao &)
+{
+    const string conteudo(1000, 'a');
+    // Um único bloco armazenado (BFINAL = 1, BTYPE = 00), seguido de LEN e NLEN
+    vector<uint8_t> fluxo = {0x01, 0xE8, 0x03, 0x17, 0xFC};
+    fluxo.insert(fluxo.end(), conteudo.begin(), conteudo.end());
+    vector<char> saida;
+    string erro;
+    if (!descompactarDeflate(fluxo.data(), fluxo.size(), conteudo.size(), saida, erro) ||
+        string(saida.begin(), saida.end()) != conteudo)
+        return "fluxo valido rejeitado: " + erro;
+    vector<char> menor;
+    if (descompactarDeflate(fluxo.data(), fluxo.size(), 10, menor, erro) || menor.size() > 10)
+        return "saida passou do tamanho declarado (" + to_string(menor.size()) + " bytes)";
+    vector<char> enorme;
+    if (descompactarDeflate(fluxo.data(), fluxo.size(), 0xFFFFFFFFu, enorme, erro))
+        return "membro menor que os 4 GB declarados aceito";
+    if (enorme.capacity() > RESERVA_MAXIMA_DESCOMPACTACAO)
+        return "reserva de " + to_string(enorme.capacity()) + " bytes com o tamanho declarado";
+    return "";
+}
+
+// Cache binário danificado: a instância gravada no cache é reaberta a partir dele; com o cabeçalho adulterado
+// (seção além do fim, contagem enorme, passo da matriz menor que a linha, chave de serviço fora da matriz) o
+// cache precisa ser descartado e a instância lida de novo do .dat, sem acessar fora do arquivo mapeado.
+string verificarCacheDanificado(const OpcoesVerificacao &opcoes)
+{
+    namespace fs = std::filesystem;
+    const string pasta = (fs::path(opcoes.pastaTemporaria) / "cache").string();
+    fs::remove_all(pasta);
+    fs::create_directories(fs::path(pasta) / "instancias");
+    ConfigGerador config;
+    config.numNos = 120;
+    config.semente = opcoes.semente;
+    if (!escreverInstancia((fs::path(pasta) / "instancias" / "cache.dat").string(), gerarInstancia(config, "cache")))
+        return "nao foi possivel gravar a instancia em " + pasta;
+    unique_ptr<FonteInstancias> fonte = abrirFonteInstancias((fs::path(pasta) / "instancias").string(), true, cerr);
+    if (!fonte || fonte->quantidade() != 1)
+        return "instancia de teste nao encontrada em " + pasta;
+    OpcoesExecucao opcoesExecucao;
+    opcoesExecucao.pastaCache = pasta;
+    ostringstream erros;
+    string caminhoCache;
+    {
+        InstanciaPreparada inst;
+        if (!lerInstancia(*fonte, 0, opcoesExecucao, inst, erros))
+            return "instancia valida rejeitada";
+        if (!calcularDistanciasInstancia(opcoesExecucao, ConfigFloydWarshall(), inst, erros))
+            return "distancias nao calculadas: " + erros.str();
+        gravarCacheInstanciaPreparada(inst, erros);
+        caminhoCache = inst.caminhoCache;
+    }
+    const string original = lerArquivoTexto(caminhoCache);
+    CabecalhoCache cab;
+    if (original.size() < sizeof(cab))
+        return "cache nao gravado: " + caminhoCache;
+    memcpy(&cab, original.data(), sizeof(cab));
+
+    // Cada adulteração altera o cabeçalho ou o primeiro serviço de uma cópia do cache íntegro
+    const vector<pair<string, function<void(CabecalhoCache &, string &)>>> adulteracoes = {
+        {"integro", [](CabecalhoCache &, string &) {}},
+        {"servicos alem do fim", [](CabecalhoCache &c, string &) { c.offServicos = c.tamTotal; }},
+        {"contagem de arestas enorme", [](CabecalhoCache &c, string &) { c.numArestas = ~uint64_t(0) / 2; }},
+        {"passo da matriz menor que a linha", [](CabecalhoCache &c, string &) { c.passoMatriz = c.numChaves; }},
+        {"chave de servico fora da matriz", [](CabecalhoCache &c, string &bytes)
+         {
+             Servico s;
+             memcpy(&s, bytes.data() + c.offServicos, sizeof(s));
+             s.chaveU = c.numChaves + 5;
+             memcpy(&bytes[c.offServicos], &s, sizeof(s));
+         }},
+    };
+    for (const auto &[descricao, adulterar] : adulteracoes)
+    {
+        string bytes = original;
+        CabecalhoCache c = cab;
+        adulterar(c, bytes);
+        memcpy(&bytes[0], &c, sizeof(c));
+        ofstream(caminhoCache, ios::binary | ios::trunc) << bytes;
+        InstanciaPreparada inst;
+        if (!lerInstancia(*fonte, 0, opcoesExecucao, inst, erros))
+            return "instancia rejeitada com cache " + descricao;
+        if (inst.carregadaDoCache != (descricao == "integro"))
+            return string("cache ") + descricao + (inst.carregadaDoCache ? " aceito" : " descartado");
+    }
+    fs::remove_all(pasta);
+    return "";
+}
+
+// Reotimização incremental (ReotimizacaoDinamica): para cada instância, a solução do modo padrão (construtivo
+// e busca local) é gravada em sol-*.dat e carregada de volta (mesmo custo); em seguida são aplicadas alteracoesPorInstancia inclusões (serviços de
+// nó, aresta ou arco sorteados) e cancelamentos alternados, com busca local de reparo, e a solução é conferida
+// após cada alteração. Imprime o número de alterações e o tempo médio e máximo de cada uma.
+string verificarReotimizacao(const OpcoesVerificacao &opcoes)
+{
+    namespace fs = std::filesystem;
+    string caminho = opcoes.instancias;
+    const string pasta = (fs::path(opcoes.pastaTemporaria) / "reotimizacao").string();
+    fs::remove_all(pasta);
+    fs::create_directories(pasta);
+    if (caminho.empty())
+    {
+        caminho = pasta;
+        for (int tamanho : {60, 150, 400})
+        {
+            ConfigGerador config;
+            config.numNos = tamanho;
+            config.semente = opcoes.semente;
+            const string nome = "sintetica-n" + to_string(tamanho);
+            if (!escreverInstancia((fs::path(pasta) / (nome + ".dat")).string(), gerarInstancia(config, nome)))
+                return "nao foi possivel gravar as instancias sinteticas em " + pasta;
+        }
+    }
+    unique_ptr<FonteInstancias> fonte = abrirFonteInstancias(caminho, true, cerr);
+    if (!fonte || fonte->quantidade() == 0)
+        return "nenhuma instancia em " + caminho;
+
+    mt19937_64 gerador(opcoes.semente);
+    auto sortear = [&](int n)
+    { return static_cast<int>(gerador() % static_cast<unsigned long long>(n)); };
+    OpcoesExecucao opcoesExecucao;
+    BufferSaida buffer;
+    ostringstream mensagens;
+    long long alteracoes = 0;
+    double somaSegundos = 0, maiorSegundos = 0;
+    for (int i = 0; i < fonte->quantidade(); ++i)
+    {
+        InstanciaPreparada inst;
+        if (!lerInstancia(*fonte, i, opcoesExecucao, inst, mensagens))
+            continue; // Instâncias inválidas são rejeitadas na leitura, como no programa principal
+        if (!calcularDistanciasInstancia(opcoesExecucao, ConfigFloydWarshall(), inst, mensagens))
+            return inst.nomeInstancia + ": " + mensagens.str();
+        // Mesma solução que o programa grava no modo padrão: construtivo seguido da busca local
+        Solucao inicial = construirSolucaoGulosa(inst, TAMANHO_LISTA_CANDIDATOS, mensagens, mensagens);
+        bool rotasAlcancaveis = inst.chaveDeposito > 0;
+        for (Rota &r : inicial.rotas)
+            rotasAlcancaveis = rotasAlcancaveis && recalcularRota(r, inst.servicos, inst.distChaves, inst.chaveDeposito);
+        if (rotasAlcancaveis && !inicial.rotas.empty())
+            BuscaLocal(inst.servicos, inst.distChaves, inst.chaveDeposito, inst.capacidadeVeiculo, ConfigBuscaLocal())
+                .otimizar(inicial);
+        const string arqSolucao = (fs::path(pasta) / ("sol-" + inst.nomeInstancia + ".dat")).string();
+        if (!escreverSolucao(arqSolucao, inicial, inst.servicos, 0, 0, buffer))
+            return "nao foi possivel gravar " + arqSolucao;
+
+        const DadosInstancia &dados = inst.dados;
+        ReotimizacaoDinamica reotimizacao(dados, ConfigOraculo(), ConfigFloydWarshall(), ConfigBuscaLocal());
+        ostringstream erros;
+        if (!reotimizacao.carregarSolucao(arqSolucao, erros))
+            return inst.nomeInstancia + ": " + erros.str();
+        if (reotimizacao.solucaoAtual().custoTotal != inicial.custoTotal)
+            return inst.nomeInstancia + ": custo da solucao carregada " + to_string(reotimizacao.solucaoAtual().custoTotal) +
+                   ", gravada " + to_string(inicial.custoTotal);
+
+        const MatrizDistancias dist = floydWarshall(dados.g);
+        vector<char> ativo(reotimizacao.listaServicos().size(), 1);
+        string erro = conferirSolucaoReotimizada(reotimizacao, dados, dist, ativo);
+        for (int a = 0; a < opcoes.alteracoesPorInstancia && erro.empty(); ++a)
+        {
+            const vector<Servico> &servicos = reotimizacao.listaServicos();
+            ResultadoAlteracao r;
+            if (a % 2 == 0)
+            {
+                const int k = sortear(static_cast<int>(servicos.size()));
+                r = reotimizacao.cancelarServico(servicos[k].idGlobal);
+                if (r.aplicada)
+                    ativo[k] = 0;
+            }
+            else
+            {
+                Servico novo{};
+                const int tipo = sortear(3);
+                if (tipo == 1 && !dados.g.arestas.empty())
+                {
+                    const Aresta &e = dados.g.arestas[sortear(static_cast<int>(dados.g.arestas.size()))];
+                    novo.tipo = Servico::Tipo::ARESTA;
+                    novo.uOriginal = e.origem;
+                    novo.vOriginal = e.destino;
+                    novo.custoTravessia = e.custo;
+                }
+                else if (tipo == 2 && !dados.g.arcos.empty())
+                {
+                    const Arco &e = dados.g.arcos[sortear(static_cast<int>(dados.g.arcos.size()))];
+                    novo.tipo = Servico::Tipo::ARCO;
+                    novo.uOriginal = e.origem;
+                    novo.vOriginal = e.destino;
+                    novo.custoTravessia = e.custo;
+                }
+                else
+                {
+                    novo.tipo = Servico::Tipo::NO;
+                    novo.idNoOriginal = 1 + sortear(dados.g.V);
+                }
+                novo.demanda = 1 + sortear(min(5, max(1, dados.capacidadeVeiculo)));
+                novo.custoServicoProprio = sortear(10);
+                r = reotimizacao.incluirServico(novo);
+                if (r.aplicada)
+                    ativo.push_back(1);
+            }
+            if (!r.aplicada)
+                continue;
+            alteracoes++;
+            somaSegundos += r.segundos;
+            maiorSegundos = max(maiorSegundos, r.segundos);
+            erro = conferirSolucaoReotimizada(reotimizacao, dados, dist, ativo);
+            if (!erro.empty())
+                erro = "alteracao " + to_string(a) + ": " + erro;
+        }
+        if (!erro.empty())
+            return inst.nomeInstancia + ", " + erro;
+    }
+    fs::remove_all(pasta);
+    if (alteracoes == 0)
+        return "nenhuma alteracao foi aplicada";
+    cout << "      " << alteracoes << " alteracoes em " << fonte->quantidade() << " instancias, media "
+         << 1000 * somaSegundos / alteracoes << " ms, maxima " << 1000 * maiorSegundos << " ms" << endl;
+    return "";
+}
+
+void imprimirUsoVerificacao(const char *nomePrograma)
+{
+    cout << "Uso: " << nomePrograma << " [opcoes]\n"
+         << "  --pasta-temp PASTA  Pasta para os arquivos temporarios das verificacoes\n"
+         << "  --semente N         Semente das instancias sinteticas e das alteracoes sorteadas (padrao 1)\n"
+         << "  --operacoes N       Alteracoes sorteadas nas distancias dinamicas (padrao 300)\n"
+         << "  --instancias CAM    Pasta ou .zip com as instancias da reotimizacao (padrao: sinteticas)\n"
+         << "  --alteracoes N      Inclusoes/cancelamentos por instancia na reotimizacao (padrao 10)\n"
+         << "  --ajuda             Mostra esta mensagem\n";
+}
+
+bool lerOpcoesVerificacao(int argc, char *argv[], OpcoesVerificacao &opcoes)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        int inteiro = 0;
+        if (arg == "--ajuda" || arg == "-h")
+        {
+            imprimirUsoVerificacao(argv[0]);
+            return false;
+        }
+        else if (arg == "--pasta-temp" && i + 1 < argc)
+            opcoes.pastaTemporaria = argv[++i];
+        else if (arg == "--semente")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, inteiro))
+                return false;
+            opcoes.semente = static_cast<unsigned long long>(inteiro);
+        }
+        else if (arg == "--operacoes")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.operacoes))
+                return false;
+        }
+        else if (arg == "--instancias" && i + 1 < argc)
+            opcoes.instancias = argv[++i];
+        else if (arg == "--alteracoes")
+        {
+            if (!lerArgumentoInteiro(argc, argv, i, opcoes.alteracoesPorInstancia))
+                return false;
+        }
+        else
+        {
+            cerr << "Opcao desconhecida: " << arg << endl;
+            imprimirUsoVerificacao(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    OpcoesVerificacao opcoes;
+    if (!lerOpcoesVerificacao(argc, argv, opcoes))
+        return 1;
+
+    const vector<pair<string, Verificacao>> verificacoes = {
+        {"leitura com area reaproveitada", verificarLeituraReaproveitada},
+        {"no requerido com identificador malformado", verificarTokenNoMalformado},
+        {"zip com diretorio central corrompido", verificarZipCorrompido},
+        {"descompactacao com tamanho declarado falso", verificarDescompactacaoLimitada},
+        {"cache de instancia danificado", verificarCacheDanificado},
+        {"distancias dinamicas x Floyd-Warshall", verificarDistanciasDinamicas},
+        {"reotimizacao: cobertura, capacidade e custos", verificarReotimizacao},
+    };
+    int falhas = 0;
+    for (const auto &[nome, verificacao] : verificacoes)
+    {
+        string erro = verificacao(opcoes);
+        cout << (erro.empty() ? "OK    " : "FALHA ") << nome << (erro.empty() ? "" : ": " + erro) << endl;
+        falhas += !erro.empty();
+    }
+    cout << verificacoes.size() - falhas << " de " << verificacoes.size() << " verificacoes passaram." << endl;
+    return falhas > 0 ? 1 : 0;
+}